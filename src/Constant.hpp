@@ -1,5 +1,6 @@
 #pragma once
-#include "stdafx.h"
+#include <string>
+#include <cstring>
 
 #define MY_PLUGIN_NAME			"VFPC (UK)"
 #define MY_PLUGIN_VERSION		"3.7.0.0"
@@ -19,19 +20,30 @@ const int TAG_FUNC_CHECKFP_CHECK = 101;
 const int TAG_FUNC_CHECKFP_DISMISS = 102;
 
 const size_t API_REFRESH_TIME = 10;
+const unsigned VALIDATION_THREADS = 2; //Background validation workers
 
 const string EVEN_DIRECTION = "EVEN";
 const string ODD_DIRECTION = "ODD";
 
 const string PLUGIN_FILE = "VFPC.dll";
 const string DATA_FILE = "Sid.json";
+const string DATA_IMAGE_FILE = "Sid.bin"; //Rule image made from Sid.json by vfpc-pack, loaded in its place
 const string LOG_FILE = "VFPC.log";
+const size_t LOG_MAX_SIZE = 2 * 1024 * 1024; //Bytes before VFPC.log is rotated to VFPC.log.1
+const size_t LOG_BUFFER_LINES = 4096; //Queued lines held before the oldest are dropped
+const string STATS_FILE = "VFPC_stats.log";
+const int STATS_DUMP_MINUTES = 5; //Default interval of ".vfpc stats file"
+const string TRACE_FILE = "VFPC_trace.json";
+const size_t TRACE_MAX_EVENTS = 1000000; //Events kept per trace, about 50 MB
+const string CACHE_DIR = "VFPC_cache\\"; //Last SID data fetched for each airport, served on startup
 
 const string COMMAND_PREFIX = ".vfpc ";
 const string LOAD_COMMAND = "load";
 const string FILE_COMMAND = "file";
 const string LOG_COMMAND = "log";
+const string TRACE_COMMAND = "trace";
 const string CHECK_COMMAND = "check";
+const string STATS_COMMAND = "stats";
 
 const string DCT_ENTRY = "DCT";
 const string SPDLVL_SEP = "/";
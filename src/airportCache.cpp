@@ -0,0 +1,110 @@
+#include "airportCache.hpp"
+#include "rapidjson/writer.h"
+#include "rapidjson/stringbuffer.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cctype>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+using namespace std;
+
+//Swaps temp in for target in one step, so target is always either the old or the new file
+static bool replaceFile(const string& temp, const string& target) {
+#ifdef _WIN32
+	//rename will not replace an existing file on Windows
+	return MoveFileExA(temp.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(temp.c_str(), target.c_str()) == 0;
+#endif
+}
+
+//ICAO codes become file names, so anything but letters and digits is refused
+static bool validIcao(const string& icao) {
+	if (icao.empty() || icao.size() > 8) {
+		return false;
+	}
+
+	for (char c : icao) {
+		if (!isalnum(static_cast<unsigned char>(c))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+string AirportCache::path(const string& icao) const {
+	return dir + icao + ".json";
+}
+
+bool AirportCache::save(const rapidjson::Value& airport, const string& lastUpdated) const {
+	string icao;
+	return stage(airport, lastUpdated, icao) && commit(icao);
+}
+
+bool AirportCache::stage(const rapidjson::Value& airport, const string& lastUpdated, string& icao) const {
+	if (!airport.IsObject() || !airport.HasMember("icao") || !airport["icao"].IsString()) {
+		return false;
+	}
+
+	string name = airport["icao"].GetString();
+	if (!validIcao(name)) {
+		return false;
+	}
+
+	rapidjson::StringBuffer buffer;
+	rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+	writer.StartObject();
+	writer.Key("last_updated");
+	writer.String(lastUpdated.c_str(), static_cast<rapidjson::SizeType>(lastUpdated.size()));
+	writer.Key("airport");
+	airport.Accept(writer);
+	writer.EndObject();
+
+	ofstream out((path(name) + ".tmp").c_str(), ios::binary | ios::trunc);
+	out.write(buffer.GetString(), buffer.GetSize());
+	if (!out) {
+		return false;
+	}
+
+	icao = name;
+	return true;
+}
+
+bool AirportCache::commit(const string& icao) const {
+	return validIcao(icao) && replaceFile(path(icao) + ".tmp", path(icao));
+}
+
+void AirportCache::discard(const string& icao) const {
+	if (validIcao(icao)) {
+		remove((path(icao) + ".tmp").c_str());
+	}
+}
+
+bool AirportCache::load(const string& icao, AirportRules& out, string& lastUpdated, vector<string>& diagnostics) const {
+	if (!validIcao(icao)) {
+		return false;
+	}
+
+	ifstream ifs(path(icao).c_str(), ios::binary);
+	if (!ifs.is_open()) {
+		return false;
+	}
+
+	stringstream ss;
+	ss << ifs.rdbuf();
+
+	rapidjson::Document data;
+	if (data.Parse<0>(ss.str().c_str()).HasParseError() || !data.IsObject() || !data.HasMember("airport")) {
+		return false;
+	}
+
+	lastUpdated = data.HasMember("last_updated") && data["last_updated"].IsString() ? data["last_updated"].GetString() : "";
+
+	//A file renamed by hand must not stand in for another airport
+	return compileAirport(data["airport"], out, diagnostics) && out.icao == icao;
+}
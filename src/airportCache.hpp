@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "rapidjson/document.h"
+#include "ruleModel.hpp"
+
+/***********************************************************
+* On-disk copy of the last SID data fetched for each airport.
+*
+* Every airport the API returns is written to its own file,
+* "<dir><ICAO>.json", holding the airport's data as the API
+* sent it and the API's last_updated stamp at the time:
+*   {"last_updated": "YYYY-MM-DD HH:MM", "airport": {...}}
+*
+* On startup the plugin serves these straight away, so tags
+* show as soon as a departure list is drawn, and the web calls
+* revalidate them against the API in the background. Files are
+* written to "<name>.tmp" first, so a half-written file is
+* never read back. A streamed response stages its airports
+* that way and only commits them once the whole response has
+* been read successfully.
+***********************************************************/
+
+class AirportCache {
+public:
+	//path must exist and end in a path separator
+	void setDirectory(const std::string& path) { dir = path; }
+
+	//Writes one airport object of an API response, returns false if it has no usable ICAO or the file cannot be written
+	bool save(const rapidjson::Value& airport, const std::string& lastUpdated) const;
+
+	//Writes an airport as save does, but to its .tmp file only - icao is set to the airport's ICAO on success
+	bool stage(const rapidjson::Value& airport, const std::string& lastUpdated, std::string& icao) const;
+
+	//Replaces the cached file of icao with its staged one
+	bool commit(const std::string& icao) const;
+
+	//Deletes the staged file of icao, leaving the cached one as it was
+	void discard(const std::string& icao) const;
+
+	//Reads and compiles the cached data for icao - false if there is none or it is unreadable
+	bool load(const std::string& icao, AirportRules& out, std::string& lastUpdated, std::vector<std::string>& diagnostics) const;
+
+	std::string path(const std::string& icao) const;
+
+private:
+	std::string dir;
+};
@@ -0,0 +1,194 @@
+#include "airportStream.hpp"
+#include "perfStats.hpp"
+
+using namespace std;
+
+//rapidjson input stream over the queued chunks - Peek and Take wait for the next chunk at the end of one
+class ChunkStream {
+public:
+	typedef char Ch;
+
+	explicit ChunkStream(AirportStream& source) : source(source) {}
+
+	//'\0' at the end of the body, as rapidjson expects
+	char Peek() { return pos < chunk.size() || refill() ? chunk[pos] : '\0'; }
+
+	char Take() { return pos < chunk.size() || refill() ? chunk[pos++] : '\0'; }
+
+	size_t Tell() const { return consumed + pos; }
+
+	//Output side of the stream concept, unused outside in situ parsing
+	char* PutBegin() { return nullptr; }
+	void Put(char) {}
+	void Flush() {}
+	size_t PutEnd(char*) { return 0; }
+
+	void skipWhitespace() {
+		char c = Peek();
+		while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+			Take();
+			c = Peek();
+		}
+	}
+
+private:
+	bool refill() {
+		consumed += chunk.size();
+		pos = 0;
+		chunk.clear();
+
+		while (source.nextChunk(chunk)) {
+			if (!chunk.empty()) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	AirportStream& source;
+	string chunk;
+	size_t pos = 0;
+	size_t consumed = 0; //Bytes in the chunks before this one
+};
+
+AirportStream::AirportStream(AirportHook onAirport) : onAirport(onAirport) {
+}
+
+AirportStream::~AirportStream() {
+	end();
+	if (parser.joinable()) {
+		parser.join();
+	}
+}
+
+void AirportStream::write(const char* data, size_t size) {
+	if (failed || size == 0) {
+		return;
+	}
+
+	{
+		lock_guard<mutex> guard(lock);
+		chunks.push_back(string(data, size));
+	}
+	wake.notify_one();
+
+	if (!parser.joinable()) {
+		parser = thread(&AirportStream::run, this);
+	}
+}
+
+bool AirportStream::finish(string& out) {
+	end();
+
+	if (!parser.joinable()) {
+		out = "No Data Returned";
+		return false;
+	}
+
+	parser.join();
+
+	if (failed) {
+		out = error;
+		return false;
+	}
+	return true;
+}
+
+void AirportStream::end() {
+	{
+		lock_guard<mutex> guard(lock);
+		ended = true;
+	}
+	wake.notify_one();
+}
+
+bool AirportStream::nextChunk(string& out) {
+	unique_lock<mutex> guard(lock);
+	wake.wait(guard, [this] { return ended || !chunks.empty(); });
+
+	if (chunks.empty()) {
+		return false;
+	}
+
+	out.swap(chunks.front());
+	chunks.pop_front();
+	return true;
+}
+
+//Same detail as a DOM parse error
+void AirportStream::fail(int code, size_t offset) {
+	error = to_string(code) + " (Offset: " + to_string(offset) + ")";
+	failed = true;
+}
+
+void AirportStream::run() {
+	traceRecorder().nameThread("Data Ingest");
+
+	ChunkStream stream(*this);
+
+	try {
+		stream.skipWhitespace();
+		if (stream.Peek() != '[') {
+			//Readable but not airports (e.g. an error page) has nothing to compile, as in compileData
+			rapidjson::Document other;
+			if (other.ParseStream<0>(stream).HasParseError()) {
+				fail(other.GetParseError(), other.GetErrorOffset());
+			}
+		}
+		else {
+			stream.Take();
+			stream.skipWhitespace();
+			bool more = stream.Peek() != ']';
+			if (!more) {
+				stream.Take();
+			}
+
+			while (more) {
+				//Only this airport's JSON is held - the reader stops where its object ends
+				rapidjson::Document airport;
+				if (airport.ParseStream<rapidjson::kParseStopWhenDoneFlag>(stream).HasParseError()) {
+					fail(airport.GetParseError(), airport.GetErrorOffset());
+					break;
+				}
+
+				if (onAirport) {
+					onAirport(airport);
+				}
+
+				{
+					StatTimer timer(Metric::DataCompile);
+					Compiled out;
+					out.rules = make_shared<AirportRules>();
+
+					if (compileAirport(airport, *out.rules, out.diagnostics)) {
+						compiled.push_back(move(out));
+					}
+				}
+
+				stream.skipWhitespace();
+				size_t at = stream.Tell();
+				char next = stream.Take();
+				if (next != ',' && next != ']') {
+					fail(rapidjson::kParseErrorArrayMissCommaOrSquareBracket, at);
+					break;
+				}
+				more = next == ',';
+			}
+
+			if (!failed) {
+				stream.skipWhitespace();
+				if (stream.Peek() != '\0') {
+					fail(rapidjson::kParseErrorDocumentRootNotSingular, stream.Tell());
+				}
+			}
+		}
+	}
+	catch (const std::exception& ex) {
+		error = ex.what();
+		failed = true;
+	}
+
+	//Whatever is still queued or yet to come is not needed
+	lock_guard<mutex> guard(lock);
+	chunks.clear();
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include "rapidjson/document.h"
+#include "ruleModel.hpp"
+
+/***********************************************************
+* Compiles an API response while it is still downloading.
+*
+* The response body - a JSON array of airports - is handed
+* over in chunks as they arrive (the curl write callback).
+* A parser thread, started with the first chunk, pulls them
+* through rapidjson's reader, which stops at the end of each
+* airport: that airport's rules are compiled and its JSON is
+* dropped before the next one is read. So neither the whole
+* body nor a document of every airport is ever held, and the
+* parse overlaps the download.
+*
+* write is called from one thread, finish from the same one
+* once the body is complete.
+***********************************************************/
+
+class AirportStream {
+public:
+	struct Compiled {
+		std::shared_ptr<AirportRules> rules;
+		std::vector<std::string> diagnostics;
+	};
+
+	//Called on the parser thread with each airport's JSON before it is compiled
+	typedef std::function<void(const rapidjson::Value& airport)> AirportHook;
+
+	explicit AirportStream(AirportHook onAirport = nullptr);
+
+	~AirportStream();
+
+	//Queues the next chunk of the body - once the data is known to be unreadable, the rest is dropped
+	void write(const char* data, size_t size);
+
+	//Ends the body and waits for the parser, false if it was not a readable array of airports
+	bool finish(std::string& error);
+
+	//Airports compiled, in response order - complete once finish has returned
+	const std::vector<Compiled>& airports() const { return compiled; }
+
+private:
+	friend class ChunkStream;
+
+	void run();
+
+	//Blocks until another chunk is queued, false at the end of the body
+	bool nextChunk(std::string& out);
+
+	void end();
+
+	//Records a parse error of the body, as rapidjson's code and the offset into the body
+	void fail(int code, size_t offset);
+
+	AirportHook onAirport;
+	std::thread parser;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::deque<std::string> chunks;
+	bool ended = false;
+	std::atomic<bool> failed{ false };
+
+	std::vector<Compiled> compiled;
+	std::string error;
+};
@@ -1,19 +1,20 @@
 #include "stdafx.h"
 #include "analyzeFP.hpp"
-#include <curl/curl.h>
 #include <future>
+#include <atomic>
 #include <chrono> // Ensure this is included
 #include <cctype> // Ensure this is included for isspace
 #include <algorithm> // Ensure this is included for all_of
+#include <sys/stat.h>
 
 
 extern "C" IMAGE_DOS_HEADER __ImageBase;
 
 bool debugMode, validVersion, autoLoad, fileLoad, apiUpdated;
+std::atomic<unsigned int> dataGeneration;
 
 vector<int> timedata;
 vector<int> lastupdate;
-vector<string> logBuffer{};
 
 size_t failPos;
 int relCount;
@@ -59,9 +60,18 @@ static inline std::string ToJsonString(const rapidjson::Document& doc)
 }
 
 //Constructor Run on Plugin Initialization
-CVFPCPlugin::CVFPCPlugin(void) :CPlugIn(EuroScopePlugIn::COMPATIBILITY_CODE, MY_PLUGIN_NAME, MY_PLUGIN_VERSION, MY_PLUGIN_DEVELOPER, MY_PLUGIN_COPYRIGHT)
+CVFPCPlugin::CVFPCPlugin(void) :CPlugIn(EuroScopePlugIn::COMPATIBILITY_CODE, MY_PLUGIN_NAME, MY_PLUGIN_VERSION, MY_PLUGIN_DEVELOPER, MY_PLUGIN_COPYRIGHT),
+	checker([this](const string& message) { bufLog(message); }),
+	logWriter(LOG_BUFFER_LINES, LOG_MAX_SIZE),
+	validator(checker, VALIDATION_THREADS)
 {
 	clearLog();
+	perfStats().setEnabled(true);
+	traceRecorder().nameThread("EuroScope");
+
+	//Fails harmlessly if it already exists
+	CreateDirectoryA((getPath() + CACHE_DIR).c_str(), NULL);
+	airportCache.setDirectory(getPath() + CACHE_DIR);
 
 	bufLog("Plugin: Load - Initialising Settings...");
 	debugMode = false;
@@ -72,8 +82,9 @@ CVFPCPlugin::CVFPCPlugin(void) :CPlugIn(EuroScopePlugIn::COMPATIBILITY_CODE, MY_
 	// Reset counters
 	failPos = 0;
 	relCount = 0;
+	dataGeneration = 0;
 
-	timedata = { 0, 0, 0, 0, 0, 0 }; // 0 = Year, 1 = Month, 2 = Day, 3 = Hour, 4 = Minute, 5 = Day of Week
+	timedata = { 0, 0, 0, 0, 0, 0 }; // Server time at last version call, for update detection - 0 = Year, 1 = Month, 2 = Day, 3 = Hour, 4 = Minute, 5 = Day of Week
 	lastupdate = { 0, 0, 0, 0, 0 }; // 0 = Year, 1 = Month, 2 = Day, 3 = Hour, 4 = Minute
 
 	// Register TAG and Function Menu.
@@ -126,15 +137,19 @@ CVFPCPlugin::CVFPCPlugin(void) :CPlugIn(EuroScopePlugIn::COMPATIBILITY_CODE, MY_
 CVFPCPlugin::~CVFPCPlugin()
 {
 	bufLog("Plugin: Unloading...");
-	writeLog();
-}
 
-//Stores output of HTTP request in string
-static size_t curlCallback(void *contents, size_t size, size_t nmemb, void *outString)
-{
-	// For Curl, we should assume that the data is not null terminated, so add a null terminator on the end
- 	((std::string*)outString)->append(reinterpret_cast<char*>(contents), size * nmemb);
-	return size * nmemb;
+	//Workers log through logWriter, so they go first
+	validator.stop();
+
+	//A trace still recording is written out rather than lost
+	if (traceRecorder().active()) {
+		traceRecorder().stop();
+		traceRecorder().write(getPath() + TRACE_FILE);
+	}
+
+	//Make sure nothing queued is lost, then stop the writer before EuroScope unloads the DLL
+	logWriter.flush();
+	logWriter.close();
 }
 
 //Gets path to current directory
@@ -151,19 +166,10 @@ string CVFPCPlugin::getPath() {
 bool CVFPCPlugin::clearLog() {
 
 	try {
-		logBuffer.clear();
-
 		string path = getPath();
 		path += LOG_FILE;
 
-		ofstream ofs;
-		ofs.open(path.c_str(), ios::trunc);
-
-		if (ofs.is_open()) {
-			ofs << "Log: Cleared Successfully." << std::endl;
-			ofs.close();
-			return true;
-		}
+		return logWriter.open(path);
 	}
 	catch (const std::exception& ex) {
 		sendMessage("Error", ex.what());
@@ -184,7 +190,7 @@ bool CVFPCPlugin::clearLog() {
 //Write to log buffer
 bool CVFPCPlugin::bufLog(string message) {
 	try {
-		logBuffer.push_back(message);
+		logWriter.push(message);
 		return true;
 	}
 	catch (const std::exception& ex) {
@@ -203,59 +209,10 @@ bool CVFPCPlugin::bufLog(string message) {
 	return false;
 }
 
-//Write contents of log buffer to file
+//Hand the log buffer to the writer thread - no disk I/O here
 bool CVFPCPlugin::writeLog() {
-
-	try {
-		string path = getPath();
-		path += LOG_FILE;
-
-		ifstream ifs;
-		ifs.open(path.c_str());
-		vector<string> file{};
-
-		if (ifs.is_open()) {
-			string line;
-			while (getline(ifs, line)) {
-				file.push_back(line);
-			}
-		}
-
-		file.insert(file.end(), logBuffer.begin(), logBuffer.end());
-
-		ifs.close();
-		size_t start = 0;
-
-		if (file.size() > 20000) {
-			start = file.size() - 20000;
-		}
-
-		ofstream ofs;
-		ofs.open(path.c_str(), ios::trunc);
-
-		if (ofs.is_open()) {
-			for (size_t i = start; i < file.size(); i++) {
-				ofs << file.at(i).c_str() << std::endl;
-			}
-			ofs.close();
-			logBuffer.clear();
-			return true;
-		}
-	}
-	catch (const std::exception& ex) {
-		sendMessage("Error", ex.what());
-		debugMessage("Error", ex.what());
-	}
-	catch (const std::string& ex) {
-		sendMessage("Error", ex);
-		debugMessage("Error", ex);
-	}
-	catch (...) {
-		sendMessage("Error", "An unexpected error occured");
-		debugMessage("Error", "An unexpected error occured");
-	}
-
-	return false;
+	logWriter.notify();
+	return true;
 }
 
 //Send message to user via "VFPC Log" channel
@@ -326,62 +283,77 @@ void CVFPCPlugin::sendMessage(string message) {
 }
 
 //CURL call, saves output to passed string reference
-bool CVFPCPlugin::webCall(string url, string& out) {
-	CURL* curl = curl_easy_init();
-	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+//If modified is passed, the request is conditional and *modified is cleared when the server reports no change
+bool CVFPCPlugin::webCall(string url, string& out, bool* modified) {
+	StatTimer timer(Metric::ApiCall);
+	string error;
+	HttpStatus status = http.get(url, out, error, modified != nullptr);
 
-	uint64_t httpCode = 0;
-
-	curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10);
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &out);
-	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlCallback);
-
-	CURLcode result = curl_easy_perform(curl);
-	//curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-	curl_easy_cleanup(curl);
-
-	if (CURLE_OK != result) {
+	if (status == HttpStatus::Failed) {
 		bufLog("Web Call To " + url + ": Failed");
-		bufLog("CURL Error : " + std::string(curl_easy_strerror(result)));
+		bufLog("CURL Error : " + error);
 		return false;
 	}
+
+	if (modified) {
+		*modified = (status != HttpStatus::NotModified);
+	}
 	return true;
 }
 
 //Makes CURL call to API server for data and stores output
-bool CVFPCPlugin::APICall(string endpoint, Document& out) {
+//If modified is passed, out must already hold this endpoint's data - it is left as is when unchanged
+bool CVFPCPlugin::APICall(string endpoint, Document& out, bool* modified) {
 	string url =  base_url_+ endpoint;
 	string buf = "";
 
 	bufLog("API Call To " + url + ": Attempting...");
 
-	if (webCall(url, buf))
+	if (webCall(url, buf, modified))
 	{
-		if (out.Parse<0>(buf.c_str()).HasParseError())
-		{
-			sendMessage("An error occurred whilst reading data. The plugin will not automatically attempt to reload from the API. To restart data fetching, type \".vfpc load\".");
-			debugMessage("Error", str(boost::format("Config Download: %s (Offset: %i)\n'") % out.GetParseError() % out.GetErrorOffset()));
-			bufLog("API Call To " + url + ": Failed - Data Returned But Unreadable");
-			return false;
-
-			out.Parse<0>("[]");
+		if (modified && !*modified) {
+			bufLog("API Call To " + url + ": Not Modified");
+			return true;
 		}
+
+		return readAPIData(url, buf, out);
 	}
 	else
 	{
-		sendMessage("An error occurred whilst downloading data. The plugin has been disabled.");
-		sendMessage("Please unload and reload the plugin to try again. (Note:.vfpc load will NOT work.");
-		debugMessage("Error", "Failed to download data from API.");
-		bufLog("API Call To " + url + ": Failed - No Data Returned");
+		apiDownloadFailed(url);
 		return false;
+	}
+}
 
-		out.Parse<0>("[]");
+//Parses data returned by the API, reporting it if unreadable
+bool CVFPCPlugin::readAPIData(string url, const string& buf, Document& out) {
+	StatTimer timer(Metric::DataParse);
+	if (out.Parse<0>(buf.c_str()).HasParseError())
+	{
+		apiDataUnreadable(url, str(boost::format("%s (Offset: %i)") % out.GetParseError() % out.GetErrorOffset()));
+		return false;
 	}
 	return true;
 }
 
+//Reports an API call whose data could not be read
+void CVFPCPlugin::apiDataUnreadable(string url, string detail) {
+	sendMessage("An error occurred whilst reading data. The plugin will not automatically attempt to reload from the API. To restart data fetching, type \".vfpc load\".");
+	debugMessage("Error", "Config Download: " + detail + "\n'");
+	bufLog("API Call To " + url + ": Failed - Data Returned But Unreadable");
+}
+
+//Reports an API call that returned nothing
+void CVFPCPlugin::apiDownloadFailed(string url) {
+	sendMessage("An error occurred whilst downloading data. The plugin has been disabled.");
+	sendMessage("Please unload and reload the plugin to try again. (Note:.vfpc load will NOT work.");
+	debugMessage("Error", "Failed to download data from API.");
+	bufLog("API Call To " + url + ": Failed - No Data Returned");
+}
+
 //Makes CURL call to API server for current date, time, and version and stores output
 bool CVFPCPlugin::versionCall() {
+	StatTimer timer(Metric::VersionCall);
 	Document version;
 	
 	if (!APICall("version", version)) {
@@ -593,6 +565,12 @@ bool CVFPCPlugin::versionCall() {
 				timedata[4] = mins;
 
 				timedata[5] = day;
+
+				//Restrictions run off the local clock - the server time only calibrates it
+				int skew = timeSource.calibrate(day, hour * 60 + mins);
+				if (abs(skew) > TimeSource::SKEW_TOLERANCE) {
+					bufLog("Version Call: Local Clock Differs From Server By " + to_string(skew) + " Minutes - Corrected");
+				}
 			}
 			catch (...) {
 				bufLog("Version Call: Time Data Unreadable - String->Int Failed");
@@ -616,6 +594,34 @@ bool CVFPCPlugin::versionCall() {
 	return out;
 }
 
+//Loads compiled data from a rule image, if there is one - returns false to fall back to Sid.json
+bool CVFPCPlugin::imageCall(RuleSnapshot& out) {
+	string path = getPath() + DATA_IMAGE_FILE;
+	string error;
+
+	struct stat image, json;
+	if (stat(path.c_str(), &image) != 0) {
+		return false;
+	}
+
+	//Edits made to Sid.json since the image was made would otherwise be hidden
+	if (stat((getPath() + DATA_FILE).c_str(), &json) == 0 && json.st_mtime > image.st_mtime) {
+		bufLog(DATA_IMAGE_FILE + " Older Than " + DATA_FILE + " - Ignored");
+		return false;
+	}
+
+	bufLog("Opening " + DATA_IMAGE_FILE + " File");
+	if (!loadRuleImage(path, out, error)) {
+		out.airports.clear();
+		debugMessage("Error", DATA_IMAGE_FILE + ": " + error + " - Loading " + DATA_FILE + " Instead.");
+		bufLog("Image Read Failed - " + error);
+		return false;
+	}
+
+	bufLog("Image Read: " + to_string(out.airports.size()) + " Airports Loaded");
+	return true;
+}
+
 //Loads data from file
 bool CVFPCPlugin::fileCall(Document &out) {
 	string path = getPath();
@@ -630,6 +636,7 @@ bool CVFPCPlugin::fileCall(Document &out) {
 		ss << ifs.rdbuf();
 		ifs.close();
 
+		StatTimer timer(Metric::DataParse);
 		if (out.Parse<0>(ss.str().c_str()).HasParseError()) {
 			sendMessage("An error occurred whilst reading data. The plugin will not automatically attempt to reload. To restart data fetching from the API, type \"" + COMMAND_PREFIX + LOAD_COMMAND + "\". To reattempt loading data from the Sid.json file, type \"" + COMMAND_PREFIX + FILE_COMMAND + "\".");
 			debugMessage("Error", str(boost::format("Config Parse: %s (Offset: %i)\n'") % out.GetParseError() % out.GetErrorOffset()));
@@ -687,6 +694,11 @@ bool CVFPCPlugin::LoadSettingsFromJson(const std::string& filename) {
 
 	base_url_ = bu["base_url"].GetString();
 
+	//Optional - older settings files predate it
+	if (bu.HasMember("per_airport") && bu["per_airport"].IsBool()) {
+		per_airport_ = bu["per_airport"].GetBool();
+	}
+
 	//---------- Load colour settings. ----------
 	if (!doc.HasMember("colours") || !doc["colours"].IsObject()) {
 		bufLog("Error: Invalid colour format in settings file: " + filename);
@@ -743,6 +755,7 @@ bool CVFPCPlugin::WriteDefaultSettingsJson(const std::string& filename)
 			a);
 
 		curl.AddMember("base_url", baseUrl, a);
+		curl.AddMember("per_airport", true, a);
 		doc.AddMember("curl", curl, a);
 	}
 
@@ -788,22 +801,48 @@ bool CVFPCPlugin::WriteDefaultSettingsJson(const std::string& filename)
 
 //Loads data and sorts into airports
 void CVFPCPlugin::getSids() {
+	StatTimer timer(Metric::GetSids);
+
 	try {
+		std::shared_ptr<RuleSnapshot> next = nullptr;
+		bool fetched = false;
+
+		//Snapshot this load replaces - if the UI clears the data meanwhile, the result is discarded
+		RuleSnapshotPtr previous = ruleStore.load();
+
 		//Load data from API
 		if (autoLoad) {
 			if (apiUpdated) {
 
 				if (activeAirports.size() > 0) {
 
-					string endpoint = "airport?icao=";
-
-					for (size_t i = 0; i < activeAirports.size(); i++) {
-						endpoint += activeAirports[i] + "+";
+					if (per_airport_) {
+						bool failed = false;
+						next = fetchAirports(*previous, failed);
+						autoLoad = !failed;
+						fetched = true;
 					}
+					else {
+						string endpoint = "airport?icao=";
+
+						for (size_t i = 0; i < activeAirports.size(); i++) {
+							endpoint += activeAirports[i] + "+";
+						}
 
-					endpoint = endpoint.substr(0, endpoint.size() - 1);
+						endpoint = endpoint.substr(0, endpoint.size() - 1);
 
-					autoLoad = APICall(endpoint, config);
+						//Only skip the parse if config already holds this endpoint's data
+						bool modified = true;
+						autoLoad = APICall(endpoint, config, endpoint == configEndpoint ? &modified : nullptr);
+						configEndpoint = autoLoad ? endpoint : "";
+
+						//A failed call leaves next null, so the data already published (e.g. served from the cache) stays
+						if (autoLoad && modified) {
+							next = std::make_shared<RuleSnapshot>();
+							compileData(config, *next);
+							cacheAirports(config);
+						}
+					}
 				}
 
 				apiUpdated = false;
@@ -811,20 +850,31 @@ void CVFPCPlugin::getSids() {
 		}
 		//Load data from Sid.json file
 		else if (fileLoad) {
-			fileLoad = fileCall(config);
+			next = std::make_shared<RuleSnapshot>();
+			configEndpoint.clear();
+
+			if (!imageCall(*next)) {
+				fileLoad = fileCall(config);
+				compileData(config, *next);
+			}
+		}
+
+		//Unchanged data stays published as is
+		if (!next) {
+			return;
 		}
 
-		//Sort new data into airports
+		//Cached check results were computed against the previous data
+		next->generation = ++dataGeneration;
 
-		airports.clear();
-		for (SizeType i = 0; i < config.Size(); i++) {
-			const Value& airport = config[i];
-			if (airport.HasMember("icao") && airport["icao"].IsString()) {
-				string airport_icao = airport["icao"].GetString();
-				bufLog("SID Data: " + airport_icao + " - Found.");
-				airports.insert(pair<string, SizeType>(airport_icao, i));
+		if (ruleStore.replace(previous, next)) {
+			if (fetched) {
+				fetchedGeneration = next->generation;
 			}
 		}
+		else {
+			bufLog("SID Data: Discarded - Data Cleared During Load");
+		}
 	}
 	catch (const std::exception& ex) {
 		sendMessage("Error", ex.what());
@@ -840,1833 +890,354 @@ void CVFPCPlugin::getSids() {
 	}
 }
 
-vector<bool> CVFPCPlugin::checkDestination(const Value& conditions, string destination, vector<bool> in) {
-	vector<bool> out{};
-
-	for (size_t i = 0; i < conditions.Size(); i++) {
-		if (!in[i]) {
-			out.push_back(false);
-			continue;
-		}
-
-		bool res = true;
-
-		if (conditions[i]["nodests"].IsArray() && conditions[i]["nodests"].Size()) {
-			string dest;
-			if (destArrayContains(conditions[i]["nodests"], destination.c_str()).size()) {
-				res = false;
+//Fetches each active airport separately and concurrently, recompiling only airports whose data changed
+//Each response is compiled while it downloads - see AirportStream
+//Returns nullptr if nothing changed
+std::shared_ptr<RuleSnapshot> CVFPCPlugin::fetchAirports(const RuleSnapshot& current, bool& failed) {
+	vector<string> icaos = activeAirports;
+	vector<string> urls{};
+	vector<std::unique_ptr<AirportStream>> streams{};
+	vector<BodySink> sinks{};
+	vector<vector<string>> staged(icaos.size()); //Airports of each response written to the cache but not yet committed
+	string stamp = cacheStamp();
+
+	for (size_t i = 0; i < icaos.size(); i++) {
+		urls.push_back(base_url_ + "airport?icao=" + icaos[i]);
+		bufLog("API Call To " + urls.back() + ": Attempting...");
+
+		//Staged as it is parsed, as the response is not kept to save afterwards
+		vector<string>* written = &staged[i];
+		streams.push_back(std::unique_ptr<AirportStream>(new AirportStream([this, stamp, written](const Value& airport) {
+			StatTimer timer(Metric::CacheSave);
+			string icao;
+			if (airportCache.stage(airport, stamp, icao)) {
+				written->push_back(icao);
 			}
-		}
-
-		if (conditions[i]["dests"].IsArray() && conditions[i]["dests"].Size()) {
-			string dest;
-			if (!destArrayContains(conditions[i]["dests"], destination.c_str()).size()) {
-				res = false;
+			else {
+				bufLog("SID Data Cache: Airport Of Response Not Saved");
 			}
-		}
+		})));
 
-		out.push_back(res);
+		AirportStream* stream = streams.back().get();
+		sinks.push_back([stream](const char* data, size_t size) { stream->write(data, size); });
 	}
 
-	return out;
-}
+	//A 304 means "same as the last response" - only current if this path published it, and streamed bodies are not kept to reread
+	bool reuse = (current.generation == fetchedGeneration);
 
-vector<bool> CVFPCPlugin::checkExitPoint(const Value& conditions, vector<string> points, vector<bool> in) {
-	vector<bool> out{};
+	vector<HttpResponse> responses{};
+	{
+		StatTimer timer(Metric::ApiCall);
+		http.getAll(urls, responses, reuse, &sinks);
+	}
 
-	for (size_t i = 0; i < conditions.Size(); i++) {
-		if (!in[i]) {
-			out.push_back(false);
-			continue;
-		}
+	std::shared_ptr<RuleSnapshot> next = std::make_shared<RuleSnapshot>();
+	bool changed = false;
 
-		bool res = true;
+	for (size_t i = 0; i < icaos.size(); i++) {
+		map<string, std::shared_ptr<const AirportRules>>::const_iterator kept = current.airports.find(icaos[i]);
 
-		if (conditions[i].HasMember("points") && conditions[i]["points"].IsArray() && conditions[i]["points"].Size()) {
-			bool temp = false;
+		//Waits for the parser, so staged[i] is complete
+		string error;
+		bool readable = streams[i]->finish(error);
 
-			for (string each : points) {
-				if (arrayContains(conditions[i]["points"], each)) {
-					temp = true;
-				}
+		//Only a response that was read in full replaces what the cache holds
+		for (string icao : staged[i]) {
+			if (responses[i].status != HttpStatus::Ok || !readable) {
+				airportCache.discard(icao);
 			}
-
-			if (!temp) {
-				res = false;
+			else if (!airportCache.commit(icao)) {
+				bufLog("SID Data Cache: " + icao + " Not Saved");
 			}
 		}
 
-		if (conditions[i].HasMember("nopoints") && conditions[i]["nopoints"].IsArray() && conditions[i]["nopoints"].Size()) {
-			bool temp = false;
-
-			for (string each : points) {
-				if (arrayContains(conditions[i]["nopoints"], each)) {
-					temp = true;
-				}
+		if (responses[i].status == HttpStatus::Failed) {
+			bufLog("CURL Error : " + responses[i].error);
+			if (failed) {
+				bufLog("API Call To " + urls[i] + ": Failed - No Data Returned");
+			}
+			else {
+				apiDownloadFailed(urls[i]);
+				failed = true;
 			}
 
-			if (temp) {
-				res = false;
+			//Previous data is better than none
+			if (kept != current.airports.end()) {
+				next->airports.insert(*kept);
 			}
+			continue;
 		}
 
-		out.push_back(res);
-	}
-
-	return out;
-}
-
-vector<bool> CVFPCPlugin::checkRoute(const Value& conditions, vector<string> route, vector<bool> in) {
-	vector<bool> out{};
-
-	for (size_t i = 0; i < conditions.Size(); i++) {
-		if (!in[i]) {
-			out.push_back(false);
+		if (responses[i].status == HttpStatus::NotModified && reuse) {
+			bufLog("API Call To " + urls[i] + ": Not Modified");
+			if (kept != current.airports.end()) {
+				next->airports.insert(*kept);
+			}
 			continue;
 		}
 
-		bool res = true;
-
-		if (conditions[i].HasMember("route") && conditions[i]["route"].IsArray() && conditions[i]["route"].Size() && !routeContains(route, conditions[i]["route"])) {
-			res = false;
+		if (!readable) {
+			apiDataUnreadable(urls[i], error);
+			failed = true;
+			if (kept != current.airports.end()) {
+				next->airports.insert(*kept);
+			}
+			continue;
 		}
 
-		if (conditions[i].HasMember("noroute") && res && conditions[i]["noroute"].IsArray() && conditions[i]["noroute"].Size() && routeContains(route, conditions[i]["noroute"])) {
-			res = false;
+		for (const AirportStream::Compiled& each : streams[i]->airports()) {
+			addAirport(each.rules, each.diagnostics, *next);
 		}
+		changed = true;
+	}
 
-		out.push_back(res);
+	//Without a recompile, next can only differ by airports no longer active
+	if (!changed && next->airports.size() == current.airports.size()) {
+		return nullptr;
 	}
 
-	return out;
+	return next;
 }
 
-vector<bool> CVFPCPlugin::checkRestriction(CFlightPlan flightPlan, string sid_suffix, const Value& restrictions, bool *sidfails, bool *constfails) {
-	bufLog(string(flightPlan.GetCallsign()) + " Restrictions Check: " + " - SID Suffix: " + sid_suffix + ", SID Fails: " + BoolToString(*sidfails) + ", Const Fails" + BoolToString(*constfails));
-	vector<bool> res{ 0, 0 }; //0 = Constraint-Level Pass, 1 = SID-Level Pass
-	bool constExists = false;
-	if (restrictions.IsArray() && restrictions.Size()) {
-		for (size_t j = 0; j < restrictions.Size(); j++) {
-			bool temp = true;
-			bool sidlevel = false;
-			bool *fails;
-
-			if (restrictions[j].HasMember("sidlevel") && (sidlevel = restrictions[j]["sidlevel"].GetBool())) {
-				fails = sidfails;
-			}
-			else {
-				fails = constfails;
-				constExists = true;
-			}
-
-			if (restrictions[j]["suffix"].IsArray() && restrictions[j]["suffix"].Size()) {
-				if (arrayContainsEnding(restrictions[j]["suffix"], sid_suffix)) {
-					fails[0] = false;
-				}
-				else {
-					temp = false;
-				}
-			}
-			else {
-				fails[0] = false;
-			}
-
-			if (restrictions[j]["types"].IsArray() && restrictions[j]["types"].Size()) {
-				fails[1] = true;
-				if (!arrayContains(restrictions[j]["types"], flightPlan.GetFlightPlanData().GetEngineType()) &&
-					!arrayContains(restrictions[j]["types"], flightPlan.GetFlightPlanData().GetAircraftType())) {
-					temp = false;
-				}
-			}
-
-			if (restrictions[j].HasMember("start") && restrictions[j].HasMember("end")) {
-				bool date = false;
-				bool time = false;
-
-				int startdate;
-				int enddate;
-				int starttime[2] = { 0,0 };
-				int endtime[2] = { 0,0 };
+//Compiles every airport in data into out
+void CVFPCPlugin::compileData(const Value& data, RuleSnapshot& out) {
+	StatTimer timer(Metric::DataCompile);
 
-				if (restrictions[j]["start"].HasMember("date")
-					&& restrictions[j]["start"]["date"].IsInt()
-					&& restrictions[j]["end"].HasMember("date")
-					&& restrictions[j]["end"]["date"].IsInt()) {
-					date = true;
+	if (!data.IsArray()) {
+		return;
+	}
 
-					startdate = restrictions[j]["start"]["date"].GetInt();
-					enddate = restrictions[j]["end"]["date"].GetInt();
-				}
+	for (SizeType i = 0; i < data.Size(); i++) {
+		const Value& airport = data[i];
+		std::shared_ptr<AirportRules> rules = std::make_shared<AirportRules>();
+		vector<string> diagnostics{};
 
-				if (restrictions[j]["start"].HasMember("time")
-					&& restrictions[j]["start"]["time"].IsString()
-					&& restrictions[j]["end"].HasMember("time")
-					&& restrictions[j]["end"]["time"].IsString()) {
-					time = true;
+		if (compileAirport(airport, *rules, diagnostics)) {
+			addAirport(rules, diagnostics, out);
+		}
+	}
+}
 
-					string startstring = restrictions[j]["start"]["time"].GetString();
-					string endstring = restrictions[j]["end"]["time"].GetString();
+//Adds a compiled airport to out, logging it and its diagnostics
+void CVFPCPlugin::addAirport(std::shared_ptr<AirportRules> rules, const vector<string>& diagnostics, RuleSnapshot& out) {
+	string airport_icao = rules->icao;
+	bufLog("SID Data: " + airport_icao + " - Found.");
 
-					starttime[0] = stoi(startstring.substr(0, 2));
-					starttime[1] = stoi(startstring.substr(2, 2));
-					endtime[0] = stoi(endstring.substr(0, 2));
-					endtime[1] = stoi(endstring.substr(2, 2));
-				}
+	for (string each : diagnostics) {
+		bufLog("SID Data: " + airport_icao + " - " + each);
+	}
 
-				bool valid = true;
+	out.airports.insert(pair<string, std::shared_ptr<const AirportRules>>(airport_icao, rules));
+}
 
-				if (date || time) {
-					fails[2] = true;
-					valid = false;
+//The API's last update, as saved with cached airports
+string CVFPCPlugin::cacheStamp() {
+	return str(boost::format("%04d-%02d-%02d %02d:%02d") % lastupdate[0] % lastupdate[1] % lastupdate[2] % lastupdate[3] % lastupdate[4]);
+}
 
-					if (!date && time) {
-						if (starttime[0] > endtime[0] || (starttime[0] == endtime[0] && starttime[1] >= endtime[1])) {
-							if (timedata[3] > starttime[0] || (timedata[3] == starttime[0] && timedata[4] >= starttime[1]) || timedata[3] < endtime[0] || (timedata[3] == endtime[0] && timedata[4] <= endtime[1])) {
-								valid = true;
-							}
-						}
-						else {
-							if ((timedata[3] > starttime[0] || (timedata[3] == starttime[0] && timedata[4] >= starttime[1])) && (timedata[3] < endtime[0] || (timedata[3] == endtime[0] && timedata[4] <= endtime[1]))) {
-								valid = true;
-							}
-						}
-					}
-					else if (startdate == enddate) {
-						if (!time) {
-							valid = true;
-						}
-						else if ((timedata[3] > starttime[0] || (timedata[3] == starttime[0] && timedata[4] >= starttime[1])) && (timedata[3] < endtime[0] || (timedata[3] == endtime[0] && timedata[4] <= endtime[1]))) {
-							valid = true;
-						}
-					}
-					else if (startdate < enddate) {
-						if (timedata[5] > startdate && timedata[5] < enddate) {
-							valid = true;
-						}
-						else if (timedata[5] == startdate) {
-							if (!time || timedata[3] > starttime[0] || (timedata[3] == starttime[0] && timedata[4] >= starttime[1])) {
-								valid = true;
-							}
-						}
-						else if (timedata[5] == enddate) {
-							if (!time || timedata[3] < endtime[0] || (timedata[3] == endtime[0] && timedata[4] < endtime[1])) {
-								valid = true;
-							}
-						}
-					}
-					else if (startdate > enddate) {
-						if (timedata[5] < startdate || timedata[5] > enddate) {
-							valid = true;
-						}
-						else if (timedata[5] == startdate) {
-							if (!time || timedata[3] > starttime[0] || (timedata[3] == starttime[0] && timedata[4] >= starttime[1])) {
-								valid = true;
-							}
-						}
-						else if (timedata[5] == enddate) {
-							if (!time || timedata[3] < endtime[0] || (timedata[3] == endtime[0] && timedata[4] < endtime[1])) {
-								valid = true;
-							}
-						}
-					}
-				}
+//Saves every airport in API data to airportCache, stamped with the API's last update
+void CVFPCPlugin::cacheAirports(const Value& data) {
+	StatTimer timer(Metric::CacheSave);
 
-				if (!valid) {
-					temp = false;
-				}
-			}
+	if (!data.IsArray()) {
+		return;
+	}
 
-			if (restrictions[j].HasMember("banned") && restrictions[j]["banned"].GetBool()) {
-				fails[3] = true;
-				temp = false;
-			}
+	string stamp = cacheStamp();
 
-			if (temp) {
-				res[sidlevel] = true;
-			}
+	for (SizeType i = 0; i < data.Size(); i++) {
+		if (!airportCache.save(data[i], stamp)) {
+			bufLog("SID Data Cache: Airport " + to_string(i) + " Of Response Not Saved");
 		}
-
-		bufLog(string(flightPlan.GetCallsign()) + " Restrictions Check: " + " - Complete");
-	}
-
-	if (!constExists) {
-		res[0] = true;
 	}
-		
-	return res;
 }
 
-vector<bool> CVFPCPlugin::checkRestrictions(CFlightPlan flightPlan, const Value& conditions, string sid_suffix, bool *sidfails, bool *constfails, bool *sidwide, vector<bool> in) {
-	vector<bool> out{};
+//Publishes cached data for active airports that have none yet, then has the web calls revalidate it straight away
+//Each airport is only looked up once, so airports the API has no data for do not hit the disk every tick
+void CVFPCPlugin::serveCached() {
+	RuleSnapshotPtr previous = ruleStore.load();
+	std::shared_ptr<RuleSnapshot> next = nullptr;
+	vector<string> served{};
 
-	for (size_t i = 0; i < conditions.Size(); i++) {
-		if (!in[i]) {
-			out.push_back(false);
+	for (string icao : activeAirports) {
+		if (previous->airports.find(icao) != previous->airports.end() || !cacheChecked.insert(icao).second) {
 			continue;
 		}
 
-		bool res = true;
-
-		vector<bool> temp = checkRestriction(flightPlan, sid_suffix, conditions[i]["restrictions"], sidfails, constfails);
+		StatTimer timer(Metric::CacheLoad);
+		std::shared_ptr<AirportRules> rules = std::make_shared<AirportRules>();
+		vector<string> diagnostics{};
+		string stamp;
 
-		res = temp[0];
-		if (temp[1]) {
-			*sidwide = true;
+		if (!airportCache.load(icao, *rules, stamp, diagnostics)) {
+			continue;
 		}
 
-		out.push_back(res);
-	}
-
-	return out;
-}
-
-vector<bool> CVFPCPlugin::checkMinMax(const Value& conditions, int RFL, vector<bool> in) {
-	vector<bool> out{};
-
-	for (size_t i = 0; i < conditions.Size(); i++) {
-		if (!in[i]) {
-			out.push_back(false);
-			continue;
+		if (!next) {
+			next = std::make_shared<RuleSnapshot>(*previous);
 		}
 
-		bool res = true;
+		bufLog("SID Data: " + icao + " - Served From Cache (Last Updated " + stamp + ")");
+		next->airports.insert(pair<string, std::shared_ptr<const AirportRules>>(icao, rules));
+		served.push_back(icao);
+	}
 
-		int Min, Max;
+	if (!next) {
+		return;
+	}
 
-		//Min Level
-		if (conditions[i].HasMember("min") && (Min = conditions[i]["min"].GetInt()) > 0 && (RFL / 100) < Min) {
-			res = false;
-		}
+	next->generation = ++dataGeneration;
 
-		//Max Level
-		if (conditions[i].HasMember("max") && (Max = conditions[i]["max"].GetInt()) > 0 && (RFL / 100) > Max) {
-			res = false;
+	if (!ruleStore.replace(previous, next)) {
+		//Try again next tick
+		for (string icao : served) {
+			cacheChecked.erase(icao);
 		}
-
-		out.push_back(res);
+		return;
 	}
 
-	return out;
+	apiUpdated = true;
+	if (relCount > 0) {
+		relCount = 0;
+	}
 }
 
-vector<bool> CVFPCPlugin::checkDirection(const Value& conditions, int RFL, vector<bool> in) {
-	vector<bool> out{};
+//Reads the flight plan fields the checker uses, except the extracted route
+FlightPlanView CVFPCPlugin::readFlightPlan(CFlightPlan flightPlan) {
+	CFlightPlanData data = flightPlan.GetFlightPlanData();
+	FlightPlanView view;
+
+	view.callsign = flightPlan.GetCallsign();
+	view.origin = data.GetOrigin();
+	view.destination = data.GetDestination();
+	view.route = data.GetRoute();
+	view.sid = data.GetSidName();
+	view.planType = data.GetPlanType();
+	view.rfl = data.GetFinalAltitude();
+	view.aircraftType = data.GetAircraftType();
+	view.engineType = data.GetEngineType();
+
+	return view;
+}
 
-	for (size_t i = 0; i < conditions.Size(); i++) {
-		if (!in[i]) {
-			out.push_back(false);
-			continue;
-		}
+//Only needed when a check is actually run
+void CVFPCPlugin::readExtractedRoute(CFlightPlan flightPlan, FlightPlanView& view) {
+	CFlightPlanExtractedRoute extracted = flightPlan.GetExtractedRoute();
 
-		//Assume any level valid if no "EVEN" or "ODD" declaration
-		bool res = true;
+	view.points.clear();
+	for (int i = 0; i < extracted.GetPointsNumber(); i++) {
+		view.points.push_back(extracted.GetPointName(i));
+	}
+}
 
-		if (conditions[i].HasMember("dir") && conditions[i]["dir"].IsString()) {
-			string direction = conditions[i]["dir"].GetString();
-			boost::to_upper(direction);
+//Current cache key for a flight plan
+CheckKey CVFPCPlugin::getCheckKey(const FlightPlanView& view, const RuleSnapshot& rules) {
+	return makeCheckKey(view, rules);
+}
 
-			if (direction == EVEN_DIRECTION) {
-				//Assume invalid until condition matched
-				res = false;
+//Returns the check result to show for a flight plan, or nullptr if it has none yet - never runs the checker, as tags repaint often
+//Without a current result the plan goes to the validator, and its last result is shown until the new one is collected
+const CheckResult* CVFPCPlugin::getCheckResult(CFlightPlan flightPlan, RuleSnapshotPtr snapshot) {
+	FlightPlanView view = readFlightPlan(flightPlan);
+	CheckKey key = getCheckKey(view, *snapshot);
+	int minuteOfWeek = timeSource.minuteOfWeek();
 
-				//Non-RVSM (Above FL410)
-				if ((RFL > RVSM_UPPER && ((RFL - RVSM_UPPER) / 1000) % 4 == 2)) {
-					res = true;
-				}
-				//RVSM (FL290-410) or Below FL290
-				else if (RFL <= RVSM_UPPER && (RFL / 1000) % 2 == 0) {
-					res = true;
-				}
-			}
-			else if (direction == ODD_DIRECTION) {
-				//Assume invalid until condition matched
-				res = false;
+	const CheckResult* result = checkResults.find(view.callsign, key, minuteOfWeek);
+	if (result) {
+		return result;
+	}
 
-				//Non-RVSM (Above FL410)
-				if ((RFL > RVSM_UPPER && ((RFL - RVSM_UPPER) / 1000) % 4 == 0)) {
-					res = true;
-				}
-				//RVSM (FL290-410) or Below FL290
-				else if (RFL <= RVSM_UPPER && (RFL / 1000) % 2 == 1) {
-					res = true;
-				}
-			}
-		}
+	//Finished since the last timer tick
+	collectChecks();
 
-		out.push_back(res);
+	if (!checkResults.holds(view.callsign, key, minuteOfWeek)) {
+		submitCheck(flightPlan, view, key, snapshot, minuteOfWeek);
 	}
 
-	return out;
+	return checkResults.last(view.callsign);
 }
 
-vector<bool> CVFPCPlugin::checkAlerts(const Value& conditions, bool *warn, vector<bool> in) {
-	vector<bool> out{};
+//Moves finished background checks into checkResults
+void CVFPCPlugin::collectChecks() {
+	vector<ValidationPool::Done> finished{};
+	validator.collect(finished);
 
-	for (size_t i = 0; i < conditions.Size(); i++) {
-		if (!in[i]) {
-			out.push_back(false);
+	for (ValidationPool::Done& each : finished) {
+		//Dropped (disconnected, data cleared) or resubmitted with newer inputs meanwhile
+		map<string, CheckKey>::iterator it = validating.find(each.callsign);
+		if (it == validating.end() || it->second != each.key) {
 			continue;
 		}
 
-		bool res = true;
-
-		if (conditions[i]["alerts"].IsArray() && conditions[i]["alerts"].Size()) {
-			for (size_t j = 0; j < conditions[i]["alerts"].Size(); j++) {
-				if (conditions[i]["alerts"][j].HasMember("ban") && conditions[i]["alerts"][j]["ban"].GetBool()) {
-					res = false;
-				}
-
-				if (conditions[i]["alerts"][j].HasMember("warn") && conditions[i]["alerts"][j]["warn"].GetBool()) {
-					*warn = true;
-				}
-			}
-		}
-
-		out.push_back(res);
+		validating.erase(it);
+		checkResults.store(each.callsign, each.key, each.result, each.minuteOfWeek, each.result.windowChange);
 	}
-
-	return out;
 }
 
-//Checks flight plan
-vector<vector<string>> CVFPCPlugin::validateSid(CFlightPlan flightPlan) {
-	
-	string callsign = flightPlan.GetCallsign();
-	//out[0] = Normal Output, out[1] = Debug Output
-	vector<vector<string>> returnOut = { vector<string>(), vector<string>() }; // 0 = Callsign, 1 = SID, 2 = Destination, 3 = Exit Point, 4 = Route, 5 = Min/Max Flight Level, 6 = Even/Odd, 7 = Suffix, 8 = Restrictions, 9 = Warnings, 10 = Bans, 11 = Syntax, 12 = Passed/Failed
-
-	returnOut[0].push_back(callsign);
-	returnOut[1].push_back(callsign);
-	for (int i = 1; i < 13; i++) {
-		returnOut[0].push_back("-");
-		returnOut[1].push_back("-");
+//Hands a flight plan to the validator, unless it is already being checked with the same inputs
+void CVFPCPlugin::submitCheck(CFlightPlan flightPlan, FlightPlanView& view, const CheckKey& key, RuleSnapshotPtr snapshot, int minuteOfWeek) {
+	map<string, CheckKey>::iterator it = validating.find(view.callsign);
+	if (it != validating.end() && it->second == key) {
+		return;
 	}
 
-	returnOut[0].back() = returnOut[1].back() = "Failed";
+	readExtractedRoute(flightPlan, view);
+	validating[view.callsign] = key;
 
-	string origin = flightPlan.GetFlightPlanData().GetOrigin(); boost::to_upper(origin);
-	string destination = flightPlan.GetFlightPlanData().GetDestination(); boost::to_upper(destination);
-	SizeType origin_int;
-
-	// Airport defined
-	if (airports.find(origin) == airports.end()) {
-		returnOut[0][1] = "Airport Not Found";
-		returnOut[0].back() = "Failed";
-
-		returnOut[1][1] = origin + " not in database.";
-		returnOut[1].back() = "Failed";
-		return returnOut;
-	}
-	else
-	{
-		origin_int = airports[origin];
-	}
-
-	int RFL = flightPlan.GetFlightPlanData().GetFinalAltitude();
-
-	string rawroute = flightPlan.GetFlightPlanData().GetRoute();
-	bufLog(callsign + string(" Validate: Route - ") + rawroute);
-	boost::trim(rawroute);
-
-	vector<string> route = split(rawroute, ' ');
+	ValidationPool::Job job;
+	job.view = std::move(view);
+	job.key = key;
+	job.rules = snapshot;
+	job.minuteOfWeek = minuteOfWeek;
+	validator.submit(std::move(job));
+}
 
-	vector<string>::iterator itr = remove_if(route.begin(), route.end(), mem_fun_ref(&string::empty));
-	route.erase(itr, route.end());
+//Applies finished background checks, then submits every departure whose inputs changed since its result was computed
+//Tag items then find their result already cached - the data of a fresh snapshot is applied to the whole list in one pass
+//Results whose restriction window opened or closed since are marked stale first, so only those flight plans are checked again
+void CVFPCPlugin::prevalidate(RuleSnapshotPtr snapshot) {
+	const int minuteOfWeek = timeSource.minuteOfWeek();
 
-	for (size_t i = 0; i < route.size(); i++) {
-		boost::to_upper(route[i]);
+	vector<string> expired{};
+	checkResults.expire(minuteOfWeek, expired);
+	if (expired.size()) {
+		bufLog("Recheck: " + to_string(expired.size()) + " Results Crossed A Restriction Window");
 	}
 
-	vector<string> points{};
-	CFlightPlanExtractedRoute extracted = flightPlan.GetExtractedRoute();
+	collectChecks();
 
-	for (int i = 0; i < extracted.GetPointsNumber(); i++) {
-		points.push_back(extracted.GetPointName(i));
+	if (snapshot->airports.empty()) {
+		return;
 	}
 
+	for (CFlightPlan flightPlan = FlightPlanSelectFirst(); flightPlan.IsValid(); flightPlan = FlightPlanSelectNext(flightPlan)) {
+		CFlightPlanData data = flightPlan.GetFlightPlanData();
+		if (snapshot->airports.find(data.GetOrigin()) == snapshot->airports.end() || isVfrPlan(data.GetPlanType()) || !Enabled(flightPlan)) {
+			continue;
+		}
 
-	string sid = flightPlan.GetFlightPlanData().GetSidName(); boost::to_upper(sid);
-	string first_wp = "";
-	string sid_suffix = "";
+		FlightPlanView view = readFlightPlan(flightPlan);
+		CheckKey key = getCheckKey(view, *snapshot);
 
-	//Route with SID
-	if (sid.length()) {
-		// Remove any # characters from SID name
-		boost::erase_all(sid, OUTDATED_SID);
+		if (!checkResults.holds(view.callsign, key, minuteOfWeek)) {
+			submitCheck(flightPlan, view, key, snapshot, minuteOfWeek);
+		}
+	}
+}
 
-		if (origin == "EGLL" && sid == "CHK") {
-			bufLog(callsign + string(" Validate: First Waypoint - EGLL CPT Easterly Procedure In Use"));
-			first_wp = "CPT";
-			sid_suffix = "CHK";
+//Handles departure list menu and menu items
+void CVFPCPlugin::OnFunctionCall(int FunctionId, const char * ItemString, POINT Pt, RECT Area) {
+	
+	try {
+		if (FunctionId == TAG_FUNC_CHECKFP_MENU) {
+			OpenPopupList(Area, "Options", 1);
+			AddPopupListElement("Show Checks", "", TAG_FUNC_CHECKFP_CHECK);
+			AddPopupListElement("Toggle Checks", "", TAG_FUNC_CHECKFP_DISMISS);
 		}
-		else {
-			first_wp = sid.substr(0, sid.find_first_of("0123456789"));
-			sid_suffix = sid.back();
-			if (0 != first_wp.length())
-				boost::to_upper(first_wp);
-		}
-	}
-
-	// Matches Speed/Alt Data In Route
-	regex spdlvl("(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4})");
-	regex spdlvlslash("\/(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4})((A|F)[0-9]{3}|(S|M)[0-9]{4})?");
-	regex icaorwy("[A-Z]{4}(\/[0-9]{2}(L|C|R)?)?");
-	regex sidstarrwy("[A-Z]{2,5}[0-9][A-Z](\/[0-9]{2}(L|C|R)?)?");
-	regex dctspdlvl("DCT\/(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4})");
-	//regex wpt("[A-Z]{2}([A-Z]([A-Z]{2})?)?(/(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4}))?");
-	//regex coord("([0-9]{4}(N|S))|([0-9]{2}(N|S)[0-9]{2,3}(E|W))(/(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4}))?");
-	regex awy("(U)?[A-Z][0-9]{1,3}([A-Z])?");
-
-	bool success = true;
-	vector<string> new_route{};
-	string outchk{};
-	bool repeat = false;
-
-	for (size_t i = 0; i < 5; i++) {
-		if (success) {
-			if (route.size() > 0) {
-				switch (i) {
-				case 0:
-					if (regex_match(route.front(), spdlvl)) {
-						route.erase(route.begin());
-					}
-					break;
-				case 1:
-					do {
-						repeat = true;
-
-						if (regex_match(route.front(), sidstarrwy)) {
-							route.erase(route.begin());
-						}
-						else if (!strcmp(route.front().c_str(), "SID")) {
-							route.erase(route.begin());
-						}
-						else if (regex_match(route.front(), icaorwy)) {
-							if (!strcmp(route.front().substr(0, 4).c_str(), origin.c_str())) {
-								route.erase(route.begin());
-							}
-							else {
-								outchk = "Different Origin in Route";
-								success = false;
-								repeat = false;
-							}
-						}
-						else {
-							repeat = false;
-						}
-					} while (repeat);
-					break;
-				case 2:
-					do {
-						repeat = true;
-
-						if (regex_match(route.back(), sidstarrwy)) {
-							route.pop_back();
-						}
-						else if (!strcmp(route.back().c_str(), "STAR")) {
-							route.pop_back();
-						}
-						else if (regex_match(route.back(), icaorwy)) {
-							if (regex_match(route.back(), icaorwy)) {
-								if (!strcmp(route.back().substr(0, 4).c_str(), destination.c_str())) {
-									route.pop_back();
-								}
-								else {
-									outchk = "Different Destination in Route";
-									success = false;
-									repeat = false;
-								}
-							}
-						}
-						else {
-							repeat = false;
-						}
-					} while (repeat);
-					break;
-				case 3:
-					for (string each : route) {
-						if (regex_match(each, dctspdlvl)) {
-							success = false;
-						}
-						else if (strcmp(each.c_str(), "DCT")) {
-							if (regex_match(each, awy)) {
-								new_route.push_back(each);
-							}
-							else {
-								size_t slash = each.find('/');
-
-								if (slash == string::npos) {
-									new_route.push_back(each);
-								}
-								else {
-									string chng = each.substr(slash);
-
-									if (regex_match(chng, spdlvlslash)) {
-										new_route.push_back(each.substr(0, slash));
-									}
-									else {
-										outchk = "Invalid Speed/Level Change";
-										success = false;
-									}
-								}
-							}
-						}
-					}
-
-					route = new_route;
-					break;
-				case 4:
-					if (sid.length()) {
-						if (strcmp(route.front().c_str(), first_wp.c_str())) {
-							outchk = "Route Not From First Waypoint";
-							success = false;
-						}
-						else {
-							route.erase(route.begin());
-						}
-					}
-
-					break;
-				}
-			}
-			else {
-				outchk = "No Route";
-				success = false;
-			}
-		}
-	}
-
-	if (!success) {
-		returnOut[0][returnOut[0].size() - 2] = returnOut[1][returnOut[1].size() - 2] = "Invalid Syntax - " + outchk + ".";
-		returnOut[0].back() = returnOut[1].back() = "Failed";
-		return returnOut;
-	}
-
-	// Any SIDs defined
-	if (!config[origin_int].HasMember("sids") || !config[origin_int]["sids"].IsArray() || !config[origin_int]["sids"].Size()) {
-
-		returnOut[0][1] = "No SIDs or Non-SID Routes Defined";
-		returnOut[0].back() = "Failed";
-
-		returnOut[1][1] = origin + " exists in database but has no SIDs (or non-SID routes) defined.";
-		returnOut[1].back() = "Failed";
-		return returnOut;
-	}
-
-	//Find routes for selected SID
-	size_t pos = string::npos;
-	if (config[origin_int]["sids"].Size() == 1 && config[origin_int]["sids"].HasMember("point") && config[origin_int]["sids"]["point"].IsString() && config[origin_int]["sids"]["point"].GetString() == "") {
-		pos = 0;
-	}
-	else {
-		for (size_t i = 0; i < config[origin_int]["sids"].Size(); i++) {
-			if (config[origin_int]["sids"][i].HasMember("point") && !first_wp.compare(config[origin_int]["sids"][i]["point"].GetString()) && config[origin_int]["sids"][i].HasMember("constraints") && config[origin_int]["sids"][i]["constraints"].IsArray()) {
-				pos = i;
-			}
-			else if (config[origin_int]["sids"][i]["aliases"].IsArray() && config[origin_int]["sids"][i]["aliases"].Size()) {
-				for (size_t j = 0; j < config[origin_int]["sids"][i]["aliases"].Size(); j++) {
-					if (!first_wp.compare(config[origin_int]["sids"][i]["aliases"][j].GetString()) && config[origin_int]["sids"][i].HasMember("constraints") && config[origin_int]["sids"][i]["constraints"].IsArray()) {
-						pos = i;
-					}
-				}				
-			}
-		}
-	}
-
-	// Needed SID defined
-	if (pos == string::npos) {
-		if (first_wp == "") {
-			returnOut[0][1] = "SID Required";
-			returnOut[1][1] = "Non-SID departure routes not in database.";
-			returnOut[1].back() = returnOut[0].back() = "Failed";
-			return returnOut;
-		}
-		else {
-			returnOut[0][1] = "SID Not Found";
-			returnOut[1][1] = sid + " departure not in database.";
-			returnOut[1].back() = returnOut[0].back() = "Failed";
-			return returnOut;
-		}
-	} 
-	else {
-		const Value& sid_ele = config[origin_int]["sids"][pos];
-		const Value& conditions = sid_ele["constraints"];
-
-		int round = 0;
-		vector<bool> validity, new_validity;
-		vector<string> results;
-		bool sidFails[4]{ 0 };
-		bool restFails[4]{ 0 }; // 0 = Suffix, 1 = Aircraft/Engines, 2 = Date/Time Restrictions
-		bool warn = false;
-
-		//SID-Level Restrictions Array
-		sidFails[0] = true;
-		vector<bool> temp = checkRestriction(flightPlan, sid_suffix, sid_ele["restrictions"], sidFails, sidFails);
-		bool sidwide = false;
-		if (temp[0] || temp[1]) {
-			sidwide = true;
-		}
-
-		//Initialise validity array to fully true#
-		for (SizeType i = 0; i < conditions.Size(); i++) {
-			validity.push_back(true);
-		}
-			
-		//Run Checks on Constraints Array
-		while (round < 7) {
-			new_validity = {};
-
-			switch (round) {
-			case 0:
-			{
-				//Destinations
-				new_validity = checkDestination(conditions, destination, validity);
-				break;
-			}
-			case 1:
-			{
-				//Exit Points
-				new_validity = checkExitPoint(conditions, points, validity);
-				break;
-			}
-			case 2:
-			{
-				//Route
-				new_validity = checkRoute(conditions, route, validity);
-				break;
-			}
-			case 3:
-			{
-				//Restrictions Array
-				new_validity = checkRestrictions(flightPlan, conditions, sid_suffix, sidFails, restFails, &sidwide, validity);
-				break;
-			}
-			case 4:
-			{
-				//Min & Max Levels
-				new_validity = checkMinMax(conditions, RFL, validity);
-				break;
-			}
-			case 5:
-			{
-				//Even/Odd Levels
-				new_validity = checkDirection(conditions, RFL, validity);
-				break;
-			}
-			case 6:
-			{
-				//Alerts (Warn/Ban)
-				new_validity = checkAlerts(conditions, &warn, validity);
-				break;
-			}
-			}
-
-			if (all_of(new_validity.begin(), new_validity.end(), [](bool v) { return !v; })) {
-				bufLog(callsign + string(" Validate: Checks - Failed On Round ") + to_string(round));
-				break;
-			}
-			else {
-				validity = new_validity;
-				round++;
-			}
-		}
-
-		if (sid.length()) {
-			returnOut[1][1] = returnOut[0][1] = "SID - " + sid + ".";
-		}
-		else {
-			returnOut[1][1] = returnOut[0][1] = "Non-SID Route.";
-		}
-
-		if (sidwide) {
-			vector<size_t> successes{};
-
-			for (size_t i = 0; i < validity.size(); i++) {
-				if (validity[i]) {
-					successes.push_back(i);
-				}
-			}
-
-			//Generate Output
-			switch (round) {
-			case 7:
-			{
-				returnOut[1].back() = returnOut[0].back() = "Passed";
-				returnOut[1][10] = "No Route Ban.";
-			}
-			case 6:
-			{
-				if (warn) {
-					returnOut[1][9] = returnOut[0][9] = WarningsOutput(flightPlan, conditions, successes, points, destination, RFL);
-				}
-				else {
-					returnOut[1][9] = "No Warnings.";
-				}
-        
-				if (round == 6) {
-					returnOut[1][10] = returnOut[0][10] = BansOutput(flightPlan, conditions, successes, points, destination, RFL);
-				}
-
-				returnOut[0][6] = "Passed Odd-Even Rule.";
-				returnOut[1][6] = "Passed " + DirectionOutput(flightPlan, conditions, successes);
-			}
-			case 5:
-			{
-				if (round == 5) {
-					returnOut[1][6] = returnOut[0][6] = "Failed " + DirectionOutput(flightPlan, conditions, successes);
-				}
-
-				returnOut[0][5] = "Passed Min/Max Level.";
-				returnOut[1][5] = "Passed " + MinMaxOutput(flightPlan, conditions, successes);
-			}
-			case 4:
-			{
-				if (round == 4) {
-					returnOut[1][5] = returnOut[0][5] = "Failed " + MinMaxOutput(flightPlan, conditions, successes) + " Alternative " + RouteOutput(flightPlan, conditions, successes, points, destination, RFL, true);
-				}
-
-				returnOut[0][8] = "Passed SID Restrictions.";
-				returnOut[1][8] = "Passed " + RestrictionsOutput(flightPlan, sid_ele, true, true, true, successes);
-			}
-			case 3:
-			{
-
-				returnOut[0][7] = "Valid Suffix.";
-				returnOut[1][7] = "Valid " + SuffixOutput(flightPlan, sid_ele, successes);
-
-				if (round == 3) {
-					if (restFails[0]) {
-						returnOut[1][7] = returnOut[0][7] = "Invalid " + SuffixOutput(flightPlan, sid_ele, successes);
-					}
-					else {
-						//NOTE: In the following it used to be restFails[1], [2], and [4]. However, [4] does not exist. This is assumed to be a typo and has been changed to [3].
-						returnOut[1][8] = returnOut[0][8] = "Failed " + RestrictionsOutput(flightPlan, sid_ele, restFails[1], restFails[2], restFails[3], successes) + " " + AlternativesOutput(flightPlan, sid_ele, successes);
-					}
-				}
-
-				returnOut[0][4] = "Passed Route.";
-				returnOut[1][4] = "Passed Route. " + RouteOutput(flightPlan, conditions, successes, points, destination, RFL);
-			}
-			case 2:
-			{
-				if (round == 2) {
-					returnOut[1][4] = returnOut[0][4] = "Failed Route. " + RouteOutput(flightPlan, conditions, successes, points, destination, RFL);
-				}
-
-				returnOut[0][3] = "Passed Exit Point.";
-				returnOut[1][3] = "Passed " + ExitPointOutput(flightPlan, origin_int, points);
-			}
-			case 1:
-			{
-				if (round == 1) {
-					returnOut[1][3] = returnOut[0][3] = "Failed " + ExitPointOutput(flightPlan, origin_int, points);
-				}
-
-				returnOut[0][2] = "Passed Destination.";
-				returnOut[1][2] = "Passed " + DestinationOutput(flightPlan, origin_int, destination);
-			}
-			case 0:
-			{
-				if (round == 0) {
-					returnOut[1][2] = returnOut[0][2] = "Failed " + DestinationOutput(flightPlan, origin_int, destination);
-				}
-				break;
-			}
-			}
-		}
-		else {
-			if (sidFails[0]) {
-				returnOut[1][6] = returnOut[0][7] = "Invalid " + SuffixOutput(flightPlan, sid_ele);
-			}
-			else {
-				returnOut[0][6] = "Valid Suffix.";
-				returnOut[1][6] = "Valid " + SuffixOutput(flightPlan, sid_ele);
-
-				//sidFails[1], [2], or [3] must be false to get here
-				returnOut[1][8] = returnOut[0][8] = "Failed " + RestrictionsOutput(flightPlan, sid_ele, sidFails[1], sidFails[2], sidFails[3]) + " " + AlternativesOutput(flightPlan, sid_ele);
-			}
-		}
-
-		return returnOut;
-	}
-}
-
-//Outputs route bans as string
-string CVFPCPlugin::BansOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes, vector<string> extracted_route, string dest, int rfl) {
-	vector<string> bans{};
-	for (int each : successes) {
-		if (constraints[each]["alerts"].IsArray() && constraints[each]["alerts"].Size()) {
-			for (size_t i = 0; i < constraints[each]["alerts"].Size(); i++) {
-				if (constraints[each]["alerts"][i].HasMember("ban") && constraints[each]["alerts"][i]["ban"].IsBool() && constraints[each]["alerts"][i]["ban"].GetBool()) {
-					if (constraints[each]["alerts"][i].HasMember("srd") && constraints[each]["alerts"][i]["srd"].IsInt()) {
-						bans.push_back("SRD Note " + to_string(constraints[each]["alerts"][i]["srd"].GetInt()));
-					}
-					if (constraints[each]["alerts"][i].HasMember("note") && constraints[each]["alerts"][i]["note"].IsString()) {
-						bans.push_back(constraints[each]["alerts"][i]["note"].GetString());
-					}
-					else {
-						bans.push_back("Alternative Route: " + RouteOutput(flightPlan, constraints, successes, extracted_route, dest, rfl));
-					}
-				}
-			}
-		}
-	}
-
-	sort(bans.begin(), bans.end());
-	vector<string>::iterator itr = unique(bans.begin(), bans.end());
-	bans.erase(itr, bans.end());
-
-	string out = "";
-
-	for (string each : bans) {
-		out += each + RESULT_SEP;
-	}
-
-	if (out == "") {
-		out = NO_RESULTS;
-	}
-	else {
-		out = out.substr(0, out.length() - 2);
-	}
-
-	return "Route Banned: " + out + ".";
-}
-
-//Outputs route warnings as string
-string CVFPCPlugin::WarningsOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes, vector<string> extracted_route, string dest, int rfl) {
-	vector<string> warnings{};
-	for (int each : successes) {
-		if (constraints[each]["alerts"].IsArray() && constraints[each]["alerts"].Size()) {
-			for (size_t i = 0; i < constraints[each]["alerts"].Size(); i++) {
-				if (constraints[each]["alerts"][i].HasMember("warn") && constraints[each]["alerts"][i]["warn"].IsBool() && constraints[each]["alerts"][i]["warn"].GetBool()) {
-					if (constraints[each]["alerts"][i].HasMember("srd") && constraints[each]["alerts"][i]["srd"].IsInt()) {
-						warnings.push_back("SRD Note " + to_string(constraints[each]["alerts"][i]["srd"].GetInt()	));
-					}
-					if (constraints[each]["alerts"][i].HasMember("note") && constraints[each]["alerts"][i]["note"].IsString()) {
-						warnings.push_back(constraints[each]["alerts"][i]["note"].GetString());
-					}
-					else {
-						warnings.push_back("Alternative Route: " + RouteOutput(flightPlan, constraints, successes, extracted_route, dest, rfl));
-					}
-				}
-			}
-		}
-	}
-
-	sort(warnings.begin(), warnings.end());
-	vector<string>::iterator itr = unique(warnings.begin(), warnings.end());
-	warnings.erase(itr, warnings.end());
-
-	string out = "";
-
-	for (string each : warnings) {
-		out += each + RESULT_SEP;
-	}
-
-	if (out == "") {
-		out = NO_RESULTS;
-	}
-	else {
-		out = out.substr(0, out.length() - 2);
-	}
-
-	return "Warnings: " + out + ".";
-}
-
-//Outputs recommended alternatives (from Restrictions arrays for a SID) as string
-string CVFPCPlugin::AlternativesOutput(CFlightPlan flightPlan, const Value& sid_ele, vector<size_t> successes) {
-	vector<string> alts{};
-	const Value& constraints = sid_ele["constraints"];
-
-	vector<string> temp = AlternativesSingle(sid_ele["restrictions"]);
-	alts.insert(alts.end(), temp.begin(), temp.end());
-
-	for (size_t each : successes) {
-		temp = AlternativesSingle(constraints[each]["restrictions"]);
-		alts.insert(alts.end(), temp.begin(), temp.end());
-	}
-
-	string out = "Recommended Alternatives: ";
-
-	sort(alts.begin(), alts.end());
-	vector<string>::iterator itr = unique(alts.begin(), alts.end());
-	alts.erase(itr, alts.end());
-
-	if (!alts.size()) {
-		out = NO_RESULTS;
-	}
-	else {
-		for (string each : alts) {
-			out += each + RESULT_SEP;
-		}
-	}
-
-	return out.substr(0, out.size() - 2) + ".";
-}
-
-//Outputs recommended alternatives (from a single Restrictions array) as string
-vector<string> CVFPCPlugin::AlternativesSingle(const Value& restrictions) {
-	vector<string> alts{};
-	if (restrictions.IsArray() && restrictions.Size()) {
-		for (size_t i = 0; i < restrictions.Size(); i++) {
-			if (restrictions[i]["alt"].IsArray() && restrictions[i]["alt"].Size()) {
-				for (size_t j = 0; j < restrictions[i]["alt"].Size(); j++) {
-					if (restrictions[i]["alt"][j].IsString()) {
-						alts.push_back(restrictions[i]["alt"][j].GetString());
-					}
-				}
-			}
-		}
-	}
-
-	return alts;
-}
-
-//Outputs aircraft type and date/time restrictions (from Restrictions array) as string
-string CVFPCPlugin::RestrictionsOutput(CFlightPlan flightPlan, const Value& sid_ele, bool check_type, bool check_time, bool check_ban, vector<size_t> successes) {
-	vector<vector<string>> rests{};
-	const Value& constraints = sid_ele["constraints"];
-
-	vector<vector<string>> temp = RestrictionsSingle(sid_ele["restrictions"]);
-	rests.insert(rests.end(), temp.begin(), temp.end());
-
-	for (size_t each : successes) {
-		temp = RestrictionsSingle(constraints[each]["restrictions"]);
-		rests.insert(rests.end(), temp.begin(), temp.end());
-	}
-
-	sort(rests.begin(), rests.end());
-	vector<vector<string>>::iterator itr = unique(rests.begin(), rests.end());
-	rests.erase(itr, rests.end());
-
-	string out = "";
-	for (size_t i = 0; i < rests.size(); i++) {
-		string temp = "";
-		if (check_ban) {
-			temp += "Banned";
-		}
-
-		if (check_type && check_time) {
-			if (temp.size() > 0) {
-				temp += " for ";
-			}
-
-			temp += rests[i][0] + " Between " + rests[i][1] + ROUTE_RESULT_SEP;
-		}
-		else if (check_type) {
-			if (temp.size() > 0) {
-				temp += " for ";
-			}
-
-			temp += rests[i][0] + RESULT_SEP;
-		}
-		else if (check_time) {
-			if (temp.size() > 0) {
-				temp += " b";
-			}
-			else {
-				temp += "B";
-			}
-
-			temp += "etween " + rests[i][1] + ROUTE_RESULT_SEP;
-		}
-
-		out += temp;
-	}
-
-	if (out == "") {
-		out = NO_RESULTS;
-	}
-	else if (check_time) {
-		out = out.substr(0, out.size() - 3);
-	}
-	else {
-		out = out.substr(0, out.size() - 2);
-	}
-
-	return "SID Restrictions: " + out + ".";
-}
-
-vector<vector<string>> CVFPCPlugin::RestrictionsSingle(const Value& restrictions, bool check_type, bool check_time, bool check_ban) {
-	vector<vector<string>> rests{};
-
-	if (restrictions.IsArray() && restrictions.Size()) {
-		for (size_t i = 0; i < restrictions.Size(); i++) {
-			vector<string> this_rest{ "", "", "" };
-
-			if (restrictions[i]["types"].IsArray() && restrictions[i]["types"].Size()) {
-				for (size_t j = 0; j < restrictions[i]["types"].Size(); j++) {
-					if (restrictions[i]["types"][j].IsString()) {
-						string item = restrictions[i]["types"][j].GetString();
-
-						if (item.size() == 1) {
-							if (item == "P") {
-								this_rest[0] += "All Pistons";
-							}
-							else if (item == "T") {
-								this_rest[0] += "All Turboprops";
-							}
-							else if (item == "J") {
-								this_rest[0] += "All Jets";
-							}
-							else if (item == "E") {
-								this_rest[0] += "All Electric Aircraft";
-							}
-						}
-						else {
-							this_rest[0] += item;
-						}
-
-						this_rest[0] += RESULT_SEP;
-					}
-				}
-
-				if (this_rest[0] != "") {
-					this_rest[0] = this_rest[0].substr(0, this_rest[0].size() - 2);
-				}
-			}
-
-			if (restrictions[i].HasMember("start") && restrictions[i].HasMember("end")) {
-				bool date = false;
-				bool time = false;
-				int startdate;
-				int enddate;
-				string starttime;
-				string endtime;
-
-				if (restrictions[i]["start"].HasMember("date")
-					&& restrictions[i]["start"]["date"].IsInt()
-					&& restrictions[i]["end"].HasMember("date")
-					&& restrictions[i]["end"]["date"].IsInt()) {
-					date = true;
-
-					startdate = restrictions[i]["start"]["date"].GetInt();
-					enddate = restrictions[i]["end"]["date"].GetInt();
-				}
-
-				if (restrictions[i]["start"].HasMember("time")
-					&& restrictions[i]["start"]["time"].IsString()
-					&& restrictions[i]["end"].HasMember("time")
-					&& restrictions[i]["end"]["time"].IsString()) {
-					time = true;
-
-					string startstring = restrictions[i]["start"]["time"].GetString();
-					string endstring = restrictions[i]["end"]["time"].GetString();
-
-					starttime = startstring.substr(0, 2) + ":" + startstring.substr(2, 2);
-					endtime = endstring.substr(0, 2) + ":" + endstring.substr(2, 2);
-				}
-
-				string start = "";
-				string end = "";
-
-				if (date) {
-					start += dayIntToString(startdate);
-					end += dayIntToString(enddate);
-				}
-
-				if (time) {
-					if (date) {
-						start += " ";
-						end += " ";
-					}
-
-					start += starttime;
-					end += endtime;
-				}
-
-				if (start != "" && end != "") {
-					this_rest[1] = start + " and " + end;
-				}
-			}
-
-			if (restrictions[i].HasMember("banned") && restrictions[i]["banned"].GetBool()) {
-				this_rest[2] = "Banned";
-			}
-
-			if (!all_of(this_rest[0].begin(), this_rest[0].end(), [](unsigned char c) { return std::isspace(c); }) || 
-				!all_of(this_rest[1].begin(), this_rest[1].end(), [](unsigned char c) { return std::isspace(c); }) || 
-				!all_of(this_rest[2].begin(), this_rest[2].end(), [](unsigned char c) { return std::isspace(c); })) {
-				rests.push_back(this_rest);
-			}
-		}
-	}
-
-	return rests;
-}
-
-//Outputs valid suffices (from Restrictions array) as string
-string CVFPCPlugin::SuffixOutput(CFlightPlan flightPlan, const Value& sid_eles, vector<size_t> successes) {
-	vector<string> suffices{};
-	const Value& constraints = sid_eles["constraints"];
-
-	vector<string> temp = SuffixSingle(sid_eles["restrictions"]);
-	suffices.insert(suffices.end(), temp.begin(), temp.end());
-
-	for (size_t each : successes) {
-		temp = SuffixSingle(constraints[each]["restrictions"]);
-		suffices.insert(suffices.end(), temp.begin(), temp.end());
-	}
-
-	string out = "Suffix. Valid Suffices: ";
-
-	sort(suffices.begin(), suffices.end());
-	vector<string>::iterator itr = unique(suffices.begin(), suffices.end());
-	suffices.erase(itr, suffices.end());
-	
-	if (!suffices.size()) {
-		out += "Any.";
-	}
-	else {
-		for (string each : suffices) {
-			out += each + RESULT_SEP;
-		}
-
-		out = out.substr(0, out.size() - 2) + ".";
-	}
-
-	return out;
-}
-
-vector<string> CVFPCPlugin::SuffixSingle(const Value& restrictions) {
-	vector<string> suffices{};
-
-	if (restrictions.IsArray() && restrictions.Size()) {
-		for (size_t i = 0; i < restrictions.Size(); i++) {
-			if (restrictions[i]["suffix"].IsArray() && restrictions[i]["suffix"].Size()) {
-				for (size_t j = 0; j < restrictions[i]["suffix"].Size(); j++) {
-					if (restrictions[i]["suffix"][j].IsString()) {
-						string out = "";
-						if (restrictions[i].HasMember("banned") && restrictions[i]["banned"].GetBool()) {
-							out += "Not ";
-						}
-
-						out += restrictions[i]["suffix"][j].GetString();
-						suffices.push_back(out);
-					}
-				}
-			}
-		}
-	}
-
-	return suffices;
-}
-
-//Outputs valid cruise level direction (from Constraints array) as string
-string CVFPCPlugin::DirectionOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes) {
-	
-	bool lvls[2] { false, false };
-	for (int each : successes) {
-		if (constraints[each].HasMember("dir") && constraints[each]["dir"].IsString()) {
-			string val = constraints[each]["dir"].GetString();
-			if (val == EVEN_DIRECTION) {
-				lvls[0] = true;
-			}
-			else if (val == ODD_DIRECTION) {
-				lvls[1] = true;
-			}
-		}
-		else {
-			lvls[0] = true;
-			lvls[1] = true;
-		}
-	}
-
-	string out = "Odd-Even Rule. Required: ";
-
-	if (lvls[0] && lvls[1]) {
-		out += "Any";
-	}
-	else if (lvls[0]) {
-		out += "Even";
-	}
-	else if (lvls[1]) {
-		out += "Odd";
-	}
-	else {
-		out += "Any";
-	}
-
-	return out;
-}
-
-//Outputs valid cruise level blocks (from Constraints array) as string
-string CVFPCPlugin::MinMaxOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes) {
-	
-	vector<vector<int>> raw_lvls{};
-	for (int each : successes) {
-		vector<int> lvls = { MININT, MAXINT };
-
-		if (constraints[each].HasMember("min") && constraints[each]["min"].IsInt()) {
-			lvls[0] = constraints[each]["min"].GetInt();
-		}
-
-		if (constraints[each].HasMember("max") && constraints[each]["max"].IsInt()) {
-			lvls[1] = constraints[each]["max"].GetInt();
-		}
-
-		raw_lvls.push_back(lvls);
-	}
-
-	bool changed = false;
-	size_t i = 0;
-
-	while (i < raw_lvls.size() - 1) {
-		for (size_t j = 0; j < raw_lvls.size(); j++) {
-			if (i == j) {
-				break;
-			}
-			//Item j is a subset of Item i
-			if (raw_lvls[j][0] >= raw_lvls[i][0] && raw_lvls[j][1] <= raw_lvls[i][1]) {
-				raw_lvls.erase(raw_lvls.begin() + j);
-				changed = true;
-				break;
-			}
-			//Item j extends higher than Item i
-			else if (raw_lvls[j][0] >= raw_lvls[i][0]) {
-				raw_lvls[i][1] = raw_lvls[j][1];
-				raw_lvls.erase(raw_lvls.begin() + j);
-				changed = true;
-				break;
-			}
-			//Item j extends lower than Item i
-			else if (raw_lvls[j][1] <= raw_lvls[i][1]) {
-				raw_lvls[i][0] = raw_lvls[j][0];
-				raw_lvls.erase(raw_lvls.begin() + j);
-				changed = true;
-				break;
-			}
-		}
-
-		if (!changed) {
-			i++;
-		}
-	}
-
-	string out = "Min/Max Level: ";
-
-	for (vector<int> each : raw_lvls) {
-		if (each[0] == MININT && each[1] == MAXINT) {
-			out += "Any Level, ";
-		}
-		else if (each[0] == MININT) {
-			out += to_string(each[1]) + "-, ";
-		}
-		else if (each[1] == MAXINT) {
-			out += to_string(each[0]) + "+, ";
-
-		}
-		else {
-			out += to_string(each[0]) + "-" + to_string(each[1]);
-			out += RESULT_SEP;
-		}
-	}
-
-	out = out.substr(0, out.size() - 2) + ".";
-
-	return out;
-}
-
-//Outputs valid initial routes (from Constraints array) as string
-string CVFPCPlugin::RouteOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes, vector<string> extracted_route, string dest, int rfl, bool req_lvl) {
-	
-	vector<size_t> pos{};
-	bool lvls = false;
-
-	for (size_t i = 0; i < constraints.Size(); i++) {
-		pos.push_back(i);
-	}
-
-	size_t i = 0;
-	while (i < 7) {
-		vector<size_t> newpos{};
-		for (size_t j : pos) {
-			switch (i) {
-			//Exact dest match
-			case 0: {
-				bool res = false;
-
-				if (constraints[j]["dests"].IsArray() && constraints[j]["dests"].Size()) {
-					for (size_t k = 0; k < constraints[j]["dests"].Size(); k++) {
-						if (constraints[j]["dests"][k].IsString()) {
-							if (string(constraints[j]["dests"][k].GetString()).size() == 4 && !strcmp(constraints[j]["dests"][k].GetString(), dest.c_str())) {
-								res = true;
-							}
-						}
-					}
-				}
-
-				if (constraints[j]["nodests"].IsArray() && constraints[j]["nodests"].Size()) {
-					for (size_t k = 0; k < constraints[j]["nodests"].Size(); k++) {
-						if (constraints[j]["nodests"][k].IsString()) {
-							if (startsWith(constraints[j]["nodests"][k].GetString(), dest.c_str())) {
-								res = false;
-							}
-						}
-					}
-				}
-
-				if ((constraints[j]["points"].IsArray() && constraints[j]["points"].Size()) || (constraints[j]["nopoints"].IsArray() && constraints[j]["nopoints"].Size())) {
-					res = false;
-				}
-
-
-				if (res) {
-					newpos.push_back(j);
-				}
-				break;
-			}
-			//Any dest/nodest match
-			case 1: {
-				bool res = false;
-
-				if (constraints[j]["dests"].IsArray() && constraints[j]["dests"].Size()) {
-					for (size_t k = 0; k < constraints[j]["dests"].Size(); k++) {
-						if (constraints[j]["dests"][k].IsString()) {
-							if (startsWith(constraints[j]["dests"][k].GetString(), dest.c_str())) {
-								res = true;
-							}
-						}
-					}
-				}
-				else {
-					res = true;
-				}
-
-				if (res) {
-					newpos.push_back(j);
-				}
-				break;
-			}
-			case 2: {
-				bool res = true;
-
-				if (constraints[j]["nodests"].IsArray() && constraints[j]["nodests"].Size()) {
-					for (size_t k = 0; k < constraints[j]["nodests"].Size(); k++) {
-						if (constraints[j]["nodests"][k].IsString()) {
-							if (startsWith(constraints[j]["nodests"][k].GetString(), dest.c_str())) {
-								res = false;
-							}
-						}
-					}
-				}
-
-				if (res) {
-					newpos.push_back(j);
-				}
-				break;
-			}
-			//points/nopoints match
-			case 3: {
-				bool res = false;
-
-				if (constraints[j]["points"].IsArray() && constraints[j]["points"].Size()) {
-					for (size_t k = 0; k < extracted_route.size(); k++) {
-						if (arrayContains(constraints[j]["points"], extracted_route[k])) {
-							res = true;
-						}
-					}
-				}
-				else {
-					res = true;
-				}
-
-				if (res) {
-					newpos.push_back(j);
-				}
-				break;
-			}
-			case 4: {
-				bool res = true;
-
-				if (constraints[j]["nopoints"].IsArray() && constraints[j]["nopoints"].Size()) {
-					for (size_t k = 0; k < extracted_route.size(); k++) {
-						if (arrayContains(constraints[j]["nopoints"], extracted_route[k])) {
-							res = false;
-						}
-					}
-				}
-
-				if (res) {
-					newpos.push_back(j);
-				}
-				break;
-			}
-			//Levels match
-			case 5: {
-				bool res = true;
-
-				if (constraints[j].HasMember("min") && (!constraints[j]["min"].IsInt() || constraints[j]["min"].GetInt() > rfl / 100)) {
-					res = false;
-				}
-
-				if (constraints[j].HasMember("max") && (!constraints[j]["max"].IsInt() || constraints[j]["max"].GetInt() < rfl / 100)) {
-					res = false;
-				}
-
-				if (res) {
-					newpos.push_back(j);
-					lvls = true;
-				}
-				break;
-			}
-			//Remove anything banned
-			case 6: {
-				bool res = true;
-
-				if (constraints[j]["alerts"].IsArray() && constraints[j]["alerts"].Size()) {
-					for (size_t k = 0; k < constraints[j]["alerts"].Size(); k++) {
-						if (constraints[j]["alerts"][k].HasMember("ban") && constraints[j]["alerts"][k]["ban"].IsBool() && constraints[j]["alerts"][k]["ban"].GetBool()) {
-							res = false;
-						}
-					}
-				}
-
-				if (res) {
-					newpos.push_back(j);
-				}
-				break;
-			}
-			}
-		}
-
-		if (newpos.size() > 0) {
-			pos = newpos;
-
-			if (i == 0) {
-				i = 4;
-			}
-		}
-
-		i++;
-	}
-
-	vector<string> out{};
-
-	for (size_t each : pos) {
-		string positem = "";
-		if (constraints[each]["route"].IsArray()) {
-			for (size_t i = 0; i < constraints[each]["route"].Size(); i++) {
-				if (i > 0) {
-					positem += RESULT_SEP;
-				}
-
-				positem += constraints[each]["route"][i].GetString();
-			}
-		}
-
-		if (constraints[each]["points"].IsArray()) {
-			if (positem.size() > 0) {
-				positem += " and ";
-			}
-
-			positem += "via ";
-
-			for (size_t i = 0; i < constraints[each]["points"].Size(); i++) {
-				if (i > 0) {
-					positem += RESULT_SEP;
-				}
-
-				positem += constraints[each]["points"][i].GetString();
-			}
-		}
-
-		string negitem = "";
-		if (constraints[each]["noroute"].IsArray() || constraints[each]["nopoints"].IsArray()) {
-
-			if (constraints[each]["noroute"].IsArray()) {
-				for (size_t i = 0; i < constraints[each]["noroute"].Size(); i++) {
-					if (i > 0) {
-						negitem += RESULT_SEP;
-					}
-
-					negitem += constraints[each]["noroute"][i].GetString();
-				}
-			}
-
-			if (constraints[each]["nopoints"].IsArray()) {
-				if (negitem.size() > 0) {
-					negitem += " or ";
-				}
-
-				negitem += "via ";
-
-				for (size_t i = 0; i < constraints[each]["nopoints"].Size(); i++) {
-					if (i > 0) {
-						negitem += RESULT_SEP;;
-					}
-
-					negitem += constraints[each]["nopoints"][i].GetString();
-				}
-			}
-
-		}
-
-		string lvlitem = "";
-		int lvls[2]{ MININT, MAXINT };
-		if (constraints[each]["min"].IsInt()) {
-			lvls[0] = constraints[each]["min"].GetInt();
-		}
-		if (constraints[each]["max"].IsInt()) {
-			lvls[1] = constraints[each]["max"].GetInt();
-		}
-
-		if (lvls[0] == MININT && lvls[1] == MAXINT) {
-			lvlitem = "Any Level";
-		}
-		else if (lvls[0] == MININT) {
-			lvlitem = to_string(lvls[1]) + "-";
-		}
-		else if (lvls[1] == MAXINT) {
-			lvlitem = to_string(lvls[0]) + "+";
-
-		}
-		else {
-			lvlitem = to_string(lvls[0]) + "-" + to_string(lvls[1]);
-		}
-
-
-		if (positem.size() > 0 || negitem.size() > 0) {
-			if (negitem.size() > 0) {
-				negitem += "not ";
-
-				if (positem.size() > 0) {
-					positem += " but ";
-				}
-			}
-
-			if (lvlitem.size() > 0) {
-				negitem += " ";
-			}
-		}
-
-
-		out.push_back(positem + negitem + "(" + lvlitem + ")");
-	}
-
-	string outstring = "";
-
-	if (pos.size() == 0 || (req_lvl && !lvls)) {
-		outstring = NO_RESULTS;
-	}
-	else {
-		for (string each : out) {
-			outstring += each + " / ";
-		}
-
-		outstring = outstring.substr(0, outstring.length() - 3);
-	}
-
-	return "Valid Initial Routes: " + outstring + ".";
-}
-
-//Outputs valid FIR exit points (from Constraints array) as string
-string CVFPCPlugin::ExitPointOutput(CFlightPlan flightPlan, size_t origin_int, vector<string> points) {
-	
-	map<string, vector<string>> a{}; //Key = Exit Point, Value = Explicitly Permitted SIDs
-	vector<bool> b{}; //Implicitly Permitted SIDs (Not Explicitly Prohibited)
-
-	for (size_t i = 0; i < config[origin_int]["sids"].Size(); i++) {
-		b.push_back(false);
-
-		if (config[origin_int]["sids"][i].HasMember("point") && config[origin_int]["sids"][i]["point"].IsString()) {
-			const Value& conditions = config[origin_int]["sids"][i]["constraints"];
-			for (size_t j = 0; j < conditions.Size(); j++) {
-				if (conditions[j]["points"].IsArray() && conditions[j]["points"].Size()) {
-					for (string each : points) {
-						if (arrayContains(conditions[j]["points"], each)) {
-							if (a.find(each) == a.end()) {
-								vector<string> temp{ config[origin_int]["sids"][i]["point"].GetString() };
-								a.insert(pair<string, vector<string>>(each, temp));
-							}
-							else {
-								a[each].push_back(config[origin_int]["sids"][i]["point"].GetString());
-							}
-						}
-					}
-				}
-				else if (conditions[j]["nopoints"].IsArray() && conditions[j]["nopoints"].Size()) {
-					b[i] = true;
-					for (string each : points) {
-						if (arrayContains(conditions[i]["nopoints"], each)) {
-							b[i] = false;
-						}
-					}
-				}
-			}
-		}
-	}
-
-	vector<string> out = {};
-
-	if (a.size()) {
-		for (pair<string, vector<string>> exit : a) {
-			string single = "";
-
-			for (string each : exit.second) {
-				if (each == "") {
-					single += "No SID";
-				}
-				else {
-					single += each;
-				}
-
-				single += RESULT_SEP;
-			}
-
-			if (single.size() > 0) {
-				single = single.substr(0, single.size() - RESULT_SEP.size());
-			}
-			else {
-				single = "None";
-			}
-
-			string prefix = exit.first;
-			prefix += " is valid for: ";
-
-			out.push_back(prefix + single);
-		}
-	}
-
-	if (!all_of(b.begin(), b.end(), [](bool v) { return !v; })) {
-		string single = "";
-
-		for (size_t i = 0; i < b.size(); i++) {
-			if (b[i]) {
-				string temp = config[origin_int]["sids"][i]["point"].GetString();
-
-				if (temp == "") {
-					single += "No SID";
-				}
-				else {
-					single += temp;
-				}
-				single += RESULT_SEP;
-			}
-		}
-
-		if (single.size() > 0) {
-			single = single.substr(0, single.size() - RESULT_SEP.size());
-		}
-		else {
-			single = "None";
-		}
-
-		string prefix = "";
-		if (out.size()) {
-			prefix += "Additionally, t";
-		}
-		else {
-			prefix += "T";
-		}
-
-		prefix += "he following SIDs may perhaps be valid: ";
-
-		out.push_back(prefix + single);
-	}
-
-	string outstring = "";
-	for (string each : out) {
-		outstring += each + ". ";
-	}
-
-	if (!outstring.size()) {
-		outstring = "Not Found. ";
-	}
-
-	return "Exit Point. " + outstring.substr(0, outstring.size() - 1);
-}
-
-//Outputs valid destinations (from Constraints array) as string
-string CVFPCPlugin::DestinationOutput(CFlightPlan flightPlan, size_t origin_int, string dest) {
-	
-	vector<string> a{}; //Explicitly Permitted
-	vector<string> b{}; //Implicitly Permitted (Not Explicitly Prohibited)
-
-	for (size_t i = 0; i < config[origin_int]["sids"].Size(); i++) {
-		if (config[origin_int]["sids"][i].HasMember("point") && config[origin_int]["sids"][i]["point"].IsString()) {
-			bool push_a = false;
-			bool push_b = false;
-
-			const Value& conditions = config[origin_int]["sids"][i]["constraints"];
-			for (size_t j = 0; j < conditions.Size(); j++) {
-				if (conditions[j]["dests"].IsArray() && conditions[j]["dests"].Size()) {
-					if (destArrayContains(conditions[j]["dests"], dest) != "") {
-						push_a = true;
-					}
-				}
-				else if (conditions[j]["nodests"].IsArray() && conditions[j]["nodests"].Size()) {
-					if (destArrayContains(conditions[j]["nodests"], dest) == "") {
-						push_b = true;
-					}
-				}
-			}
-
-			string sidstr = config[origin_int]["sids"][i]["point"].GetString();
-			if (sidstr == "") {
-				sidstr = "No SID";
-			}
-
-			if (push_a) {
-				a.push_back(sidstr);
-			}
-			else if (push_b) {
-				b.push_back(sidstr);
-			}
-		}
-	}
-
-	string out = "";
-
-	if (a.size()) {
-		out += "is valid for: ";
-
-		for (string each : a) {
-			out += each;
-			out += RESULT_SEP;
-		}
-
-		out = out.substr(0, out.size() - 2) + ".";
-	}
-
-	if (b.size()) {
-		if (a.size()) {
-			out += " Additionally, " + dest + " ";
-		}
-
-		out += "may be valid for: ";
-
-		for (string each : b) {
-			out += each;
-			out += RESULT_SEP;
-		}
-
-		out = out.substr(0, out.size() - 2) + ".";
-	}
-
-	if (out == "") {
-		out = "No valid SIDs found for " + dest + out;
-	}
-	else {
-		out = dest + " " + out;
-	}
-
-	return "Destination. " + out;
-}
-
-//Handles departure list menu and menu items
-void CVFPCPlugin::OnFunctionCall(int FunctionId, const char * ItemString, POINT Pt, RECT Area) {
-	
-	try {
-		if (FunctionId == TAG_FUNC_CHECKFP_MENU) {
-			OpenPopupList(Area, "Options", 1);
-			AddPopupListElement("Show Checks", "", TAG_FUNC_CHECKFP_CHECK);
-			AddPopupListElement("Toggle Checks", "", TAG_FUNC_CHECKFP_DISMISS);
-		}
-		else if (FunctionId == TAG_FUNC_CHECKFP_CHECK) {
-			checkFPDetail();
-		}
-		else if (FunctionId == TAG_FUNC_CHECKFP_DISMISS) {
+		else if (FunctionId == TAG_FUNC_CHECKFP_CHECK) {
+			checkFPDetail();
+		}
+		else if (FunctionId == TAG_FUNC_CHECKFP_DISMISS) {
 
 			CFlightPlan flightPlan = FlightPlanSelectASEL();
 
@@ -2719,24 +1290,34 @@ bool CVFPCPlugin::Enabled(CFlightPlan flightPlan) {
 void CVFPCPlugin::OnGetTagItem(CFlightPlan flightPlan, CRadarTarget RadarTarget, int ItemCode, int TagData, char sItemString[16], int* pColorCode, COLORREF* pRGB, double* pFontSize){
 	try {
 		if (ItemCode == TAG_ITEM_CHECKFP) {
+			StatTimer timer(Metric::TagItem);
 			const char *origin = flightPlan.GetFlightPlanData().GetOrigin();
 			if (find(activeAirports.begin(), activeAirports.end(), origin) == activeAirports.end()) {
 				activeAirports.push_back(origin);
 			}
 
-			if (validVersion && Enabled(flightPlan) && airports.find(flightPlan.GetFlightPlanData().GetOrigin()) != airports.end()) {
+			RuleSnapshotPtr snapshot = ruleStore.load();
+
+			if (validVersion && Enabled(flightPlan) && snapshot->airports.find(flightPlan.GetFlightPlanData().GetOrigin()) != snapshot->airports.end()) {
 				string FlightPlanString = flightPlan.GetFlightPlanData().GetRoute();
 				int RFL = flightPlan.GetFlightPlanData().GetFinalAltitude();
 
 				*pColorCode = TAG_COLOR_RGB_DEFINED;
-				string fpType{ flightPlan.GetFlightPlanData().GetPlanType() };
-				if (fpType == "V" || fpType == "S" || fpType == "D") {
+				if (isVfrPlan(flightPlan.GetFlightPlanData().GetPlanType())) {
 					*pRGB = TAG_GREEN;
 					strcpy_s(sItemString, 16, "VFR");
 				}
 				else {
-					vector<string> validize = validateSid(flightPlan)[0]; // 0 = Callsign, 1 = SID, 2 = Destination, 3 = Exit Point, 4 = Route, 5 = Min/Max Flight Level, 6 = Even/Odd, 7 = Suffix, 8 = Restrictions, 9 = Warnings, 10 = Bans, 11 = Syntax, 12 = Passed/Failed
-					strcpy_s(sItemString, 16, getFails(flightPlan, validize, pRGB).c_str());
+					const CheckResult* result = getCheckResult(flightPlan, snapshot);
+
+					if (result) {
+						strcpy_s(sItemString, 16, getFails(*result, pRGB));
+					}
+					else {
+						//Not checked yet - the validator's result shows on a later repaint
+						*pColorCode = TAG_COLOR_DEFAULT;
+						strcpy_s(sItemString, 16, "...");
+					}
 				}
 			}
 			else {
@@ -2758,6 +1339,22 @@ void CVFPCPlugin::OnGetTagItem(CFlightPlan flightPlan, CRadarTarget RadarTarget,
 	}
 }
 
+//Marks the cached check result stale when the flight plan is amended
+void CVFPCPlugin::OnFlightPlanFlightPlanDataUpdate(CFlightPlan flightPlan) {
+	checkResults.invalidate(flightPlan.GetCallsign());
+}
+
+//Marks the cached check result stale when controller assigned data (e.g. assigned SID/RFL) changes
+void CVFPCPlugin::OnFlightPlanControllerAssignedDataUpdate(CFlightPlan flightPlan, int DataType) {
+	checkResults.invalidate(flightPlan.GetCallsign());
+}
+
+//Drops the cached check result once the flight plan leaves the network
+void CVFPCPlugin::OnFlightPlanDisconnect(CFlightPlan flightPlan) {
+	checkResults.erase(flightPlan.GetCallsign());
+	validating.erase(flightPlan.GetCallsign());
+}
+
 //Handles console commands
 bool CVFPCPlugin::OnCompileCommand(const char * sCommandLine) {
 
@@ -2800,6 +1397,17 @@ bool CVFPCPlugin::OnCompileCommand(const char * sCommandLine) {
 			}
 			return true;
 		}
+		//Chrome trace of plugin activity
+		else if (startsWith((COMMAND_PREFIX + TRACE_COMMAND).c_str(), sCommandLine)) {
+			toggleTrace();
+			return true;
+		}
+		//Hot path timings
+		else if (startsWith((COMMAND_PREFIX + STATS_COMMAND).c_str(), sCommandLine))
+		{
+			statsCommand(sCommandLine + (COMMAND_PREFIX + STATS_COMMAND).size());
+			return true;
+		}
 		//Text-Equivalent of "Show Checks" Button
 		else if (startsWith((COMMAND_PREFIX + CHECK_COMMAND).c_str(), sCommandLine))
 		{
@@ -2829,8 +1437,7 @@ void CVFPCPlugin::checkFPDetail() {
 		if (validVersion) {
 			CFlightPlan flightPlan = FlightPlanSelectASEL();
 			
-			string fpType{ flightPlan.GetFlightPlanData().GetPlanType() };
-			if (fpType == "V" || fpType == "S" || fpType == "D") {
+			if (isVfrPlan(flightPlan.GetFlightPlanData().GetPlanType())) {
 				
 				string buf = "Flight Plan Checking Not Supported For VFR Flights.";
 				sendMessage(flightPlan.GetCallsign(), buf);
@@ -2839,33 +1446,22 @@ void CVFPCPlugin::checkFPDetail() {
 			else {
 				
 				sendMessage(flightPlan.GetCallsign(), "Checking...");
-				vector<vector<string>> validize = validateSid(flightPlan);
+				RuleSnapshotPtr snapshot = ruleStore.load();
+				FlightPlanView view = readFlightPlan(flightPlan);
+				readExtractedRoute(flightPlan, view);
+
+				CheckKey key = getCheckKey(view, *snapshot);
+				int minuteOfWeek = timeSource.minuteOfWeek();
+				CheckResult checked = checker.validateSid(view, *snapshot, minuteOfWeek);
+				const CheckResult& result = checkResults.store(view.callsign, key, checked, minuteOfWeek, checked.windowChange);
+				vector<vector<string>> validize = checker.explainCheck(view, result, *snapshot);
 
 				vector<string> messageBuffer{ validize[0] }; // 0 = Callsign, 1 = SID, 2 = Destination, 3 = Exit Point, 4 = Route, 5 = Min/Max Flight Level, 6 = Even/Odd, 7 = Suffix, 8 = Restrictions, 9 = Warnings, 10 = Bans, 11 = Syntax, 12 = Passed/Failed
 				vector<string> logBuffer{ validize[1] }; // 0 = Callsign, 1 = SID, 2 = Destination, 3 = Exit Point, 4 = Route, 5 = Min/Max Flight Level, 6 = Even/Odd, 7 = Suffix, 8 = Restrictions, 9 = Warnings, 10 = Bans, 11 = Syntax, 12 = Passed/Failed
 				
-				string buffer{};
-				string logbuf{};
-
-				if (messageBuffer.at(1).find("Invalid") != 0) {
-					for (size_t i = 1; i < messageBuffer.size() - 1; i++) {
-						string temp = messageBuffer.at(i);
-						string logtemp = logBuffer.at(i);
-
-						if (temp != "-") {
-							buffer += temp;
-							buffer += " | ";
-						}
-
-						if (logtemp != "-") {
-							logbuf += logtemp;
-							logbuf += " | ";
-						}
-					}
-				}
-
-				buffer += messageBuffer.back();
-				logbuf += logBuffer.back();
+				bool stages = messageBuffer.at(1).find("Invalid") != 0;
+				string buffer = SidChecker::joinExplanation(messageBuffer, stages);
+				string logbuf = SidChecker::joinExplanation(logBuffer, stages);
 
 				sendMessage(messageBuffer.front(), buffer);
 				debugMessage(logBuffer.front(), logbuf);
@@ -2887,69 +1483,125 @@ void CVFPCPlugin::checkFPDetail() {
 
 }
 
-//Compiles list of failed elements in flight plan, in preparation for adding to departure list
-string CVFPCPlugin::getFails(CFlightPlan flightPlan, vector<string> messageBuffer, COLORREF* pRGB) {
-	
-	try {
-		*pRGB = TAG_RED;
-
-		if (messageBuffer.at(messageBuffer.size() - 2).size() > 1 || messageBuffer.at(messageBuffer.size() - 2).find("-")) {
-			return "CHK";
-		}
-		else if (messageBuffer.at(1).find("SID - ") && messageBuffer.at(1).find("Non-SID Route.")) {
-			return "SID";
-		}
-		else if (!messageBuffer.at(2).find("Failed")) {
-			return "DST";
-		}
-		else if (!messageBuffer.at(3).find("Failed")) {
-			return "XPT";
-		}
-		else if (!messageBuffer.at(4).find("Failed")) {
-			return "RTE";
-		}
-		else if (!messageBuffer.at(5).find("Failed")) {
-			return "LVL";
+//".vfpc stats" shows the timings, "reset" clears them, "file [minutes]" dumps them to STATS_FILE periodically, "file off" stops that
+void CVFPCPlugin::statsCommand(string args) {
+	vector<string> words{};
+	for (string each : split(args, ' ')) {
+		if (each.size()) {
+			words.push_back(each);
 		}
-		else if (!messageBuffer.at(6).find("Failed")) {
-			return "OER";
-		}
-		else if (!messageBuffer.at(7).find("Invalid")) {
-			return "SUF";
+	}
+
+	if (words.empty()) {
+		vector<string> lines = perfStats().report();
+		if (lines.empty()) {
+			sendMessage("Stats", "Nothing Recorded Yet.");
 		}
-		else if (!messageBuffer.at(8).find("Failed")) {
-			return "RST";
+		for (const string& line : lines) {
+			sendMessage("Stats", line);
 		}
-		else if (!messageBuffer.at(9).find("Warnings")) {
-			*pRGB = TAG_YELLOW;
+	}
+	else if (words[0] == "reset") {
+		perfStats().reset();
+		sendMessage("Stats", "Timings Reset.");
+	}
+	else if (words[0] == "file") {
+		if (words.size() > 1 && words[1] == "off") {
+			statsDumpInterval = 0;
+			sendMessage("Stats", "Periodic Dump To " + STATS_FILE + " Stopped.");
+			return;
 		}
-		else if (!messageBuffer.at(10).find("Route Banned")) {
-			return "BAN";
+
+		int minutes = STATS_DUMP_MINUTES;
+		if (words.size() > 1) {
+			try {
+				minutes = stoi(words[1]);
+			}
+			catch (...) {
+				minutes = 0;
+			}
 		}
-		else {
-			*pRGB = TAG_GREEN;
+
+		if (minutes < 1) {
+			sendMessage("Stats", "Usage: " + COMMAND_PREFIX + STATS_COMMAND + " file [minutes|off]");
+			return;
 		}
 
-		return "OK!";
+		statsDumpInterval = minutes * 60;
+		statsDumpCountdown = statsDumpInterval;
+		sendMessage("Stats", "Dumping To " + STATS_FILE + " Every " + to_string(minutes) + " Minutes.");
+		dumpStats();
 	}
-	catch (const std::exception& ex) {
-		sendMessage("Error", ex.what());
-		debugMessage("Error", ex.what());
+	else {
+		sendMessage("Stats", "Usage: " + COMMAND_PREFIX + STATS_COMMAND + " [reset|file [minutes|off]]");
 	}
-	catch (const std::string& ex) {
-		sendMessage("Error", ex);
-		debugMessage("Error", ex);
+}
+
+//Starts recording a trace, or stops and writes it to TRACE_FILE
+void CVFPCPlugin::toggleTrace() {
+	TraceRecorder& trace = traceRecorder();
+
+	if (!trace.active()) {
+		trace.start(TRACE_MAX_EVENTS);
+		sendMessage("Trace", "Recording Started. Type \"" + COMMAND_PREFIX + TRACE_COMMAND + "\" Again To Stop And Write " + TRACE_FILE + ".");
+		return;
 	}
-	catch (...) {
-		sendMessage("Error", "An unexpected error occured");
-		debugMessage("Error", "An unexpected error occured");
+
+	trace.stop();
+
+	string message = to_string(trace.size()) + " Events";
+	if (trace.dropped()) {
+		message += " (" + to_string(trace.dropped()) + " Dropped - Limit Reached)";
+	}
+
+	if (trace.write(getPath() + TRACE_FILE)) {
+		sendMessage("Trace", message + " Written To " + TRACE_FILE + ".");
+	}
+	else {
+		sendMessage("Trace", "Could Not Write " + TRACE_FILE + ".");
+	}
+}
+
+//Appends the current timings to STATS_FILE
+bool CVFPCPlugin::dumpStats() {
+	ofstream out((getPath() + STATS_FILE).c_str(), ios::app);
+	if (!out.is_open()) {
+		bufLog("Stats: Could Not Open " + STATS_FILE);
+		return false;
+	}
+
+	CivilTime now = civilFromEpoch(chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count());
+	out << str(boost::format("%04d-%02d-%02d %02d:%02d UTC") % now.year % now.month % now.day % now.hour % now.minute) << "\n";
+	for (const string& line : perfStats().report()) {
+		out << line << "\n";
+	}
+	out << "\n";
+
+	return true;
+}
+
+//Picks the departure list code and colour for a check result
+const char* CVFPCPlugin::getFails(const CheckResult& result, COLORREF* pRGB) {
+	const char* code = resultCode(result);
+
+	if (strcmp(code, "OK!")) {
+		*pRGB = TAG_RED;
+	}
+	else if (result.stages[STAGE_WARNINGS] == StageStatus::Warning) {
+		*pRGB = TAG_YELLOW;
+	}
+	else {
+		*pRGB = TAG_GREEN;
 	}
 
-	return "   ";
+	return code;
 }
 
 //Runs all web/file calls at once
 void CVFPCPlugin::runWebCalls() {
+	traceRecorder().nameThread("Web Calls");
+	StatTimer timer(Metric::WebCalls);
+
 	try {
 		validVersion = versionCall();
 		getSids();
@@ -2972,7 +1624,14 @@ void CVFPCPlugin::OnTimer(int Counter)
 {
 	if (!is_initialised) return;
 
+	StatTimer timer(Metric::Timer);
+
 	try {
+		if (statsDumpInterval > 0 && --statsDumpCountdown <= 0) {
+			statsDumpCountdown = statsDumpInterval;
+			dumpStats();
+		}
+
 		if (!validVersion) {
 			writeLog();
 			return;
@@ -2988,9 +1647,10 @@ void CVFPCPlugin::OnTimer(int Counter)
 				bufLog("User logged off from EuroScope.");
 			}
 
+			//The SID data is kept, so tags are back as soon as the connection is - it is revalidated on reconnect
 			apiUpdated = true;
-			airports.clear();
-			config.SetArray();
+			checkResults.clear();
+			validating.clear();
 			writeLog();
 			return;
 		}
@@ -3008,6 +1668,12 @@ void CVFPCPlugin::OnTimer(int Counter)
 			relCount = API_REFRESH_TIME;
 		}
 
+		// ---------- CACHED DATA ----------
+		//Not while web calls run, as they would discard what they fetched on finding the snapshot changed
+		if (autoLoad && relCount != -1) {
+			serveCached();
+		}
+
 		// ---------- COUNTDOWN / RATE LIMIT ----------
 		if (relCount > 0) {
 			--relCount;
@@ -3019,6 +1685,9 @@ void CVFPCPlugin::OnTimer(int Counter)
 			relCount = -1; // disabled until future completes reads clearer than relCount--
 		}
 
+		// ---------- BACKGROUND VALIDATION ----------
+		prevalidate(ruleStore.load());
+
 		writeLog();
 		last_update = Counter;
 	}
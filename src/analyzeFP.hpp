@@ -3,11 +3,26 @@
 #include <sstream>
 #include <iostream>
 #include <string>
-#include <regex>
 #include "Constant.hpp"
+#include "ruleModel.hpp"
+#include "ruleSnapshot.hpp"
+#include "sidChecker.hpp"
+#include "resultCache.hpp"
+#include "tagCheck.hpp"
+#include "perfStats.hpp"
+#include "validationPool.hpp"
+#include "checkResult.hpp"
+#include "logWriter.hpp"
+#include "httpClient.hpp"
+#include "timeSource.hpp"
+#include "airportCache.hpp"
+#include "airportStream.hpp"
+#include "ruleImage.hpp"
 #include <fstream>
 #include <vector>
 #include <map>
+#include <set>
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include "rapidjson/document.h"
@@ -26,59 +41,49 @@ public:
 	CVFPCPlugin();
 	virtual ~CVFPCPlugin();
 
-	virtual bool webCall(string url, string& out);
+	virtual bool webCall(string url, string& out, bool* modified = nullptr);
 
-	virtual bool APICall(string endpoint, Document& out);
+	virtual bool APICall(string endpoint, Document& out, bool* modified = nullptr);
 
-	virtual bool versionCall();
-
-	virtual bool fileCall(Document &out);
-
-	virtual void getSids();
-
-	virtual vector<bool> checkDestination(const Value& constraints, string destination, vector<bool> in);
+	virtual bool readAPIData(string url, const string& buf, Document& out);
 
-	virtual vector<bool> checkExitPoint(const Value& constraints, vector<string> extracted_route, vector<bool> in);
+	virtual void apiDownloadFailed(string url);
 
-	virtual vector<bool> checkRoute(const Value& constraints, vector<string> extracted_route, vector<bool> in);
+	virtual void apiDataUnreadable(string url, string detail);
 
-	virtual vector<bool> checkRestriction(CFlightPlan flightPlan, string sid_suffix, const Value& restrictions, bool *sidfails, bool* fails);
+	virtual bool versionCall();
 
-	virtual vector<bool> checkRestrictions(CFlightPlan flightPlan, const Value& conditions, string sid_suffix, bool *sidfails, bool* fails, bool *sidwide, vector<bool> in);
+	virtual bool fileCall(Document &out);
 
-	virtual vector<bool> checkMinMax(const Value& constraints, int RFL, vector<bool> in);
+	virtual bool imageCall(RuleSnapshot& out);
 
-	virtual vector<bool> checkDirection(const Value& constraints, int RFL, vector<bool> in);
+	virtual void getSids();
 
-	virtual vector<bool> checkAlerts(const Value& constraints, bool *warn, vector<bool> in);
+	virtual std::shared_ptr<RuleSnapshot> fetchAirports(const RuleSnapshot& current, bool& failed);
 
-	virtual vector<vector<string>> validateSid(CFlightPlan flightPlan);
+	virtual void compileData(const Value& data, RuleSnapshot& out);
 
-	virtual string BansOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes, vector<string> extracted_route, string dest, int rfl);
+	virtual void addAirport(std::shared_ptr<AirportRules> rules, const vector<string>& diagnostics, RuleSnapshot& out);
 
-	virtual string WarningsOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes, vector<string> extracted_route, string dest, int rfl);
-	
-	virtual string AlternativesOutput(CFlightPlan flightPlan, const Value& sid_ele, vector<size_t> successes = {});
+	virtual string cacheStamp();
 
-	virtual vector<string> AlternativesSingle(const Value& sid_ele);
+	virtual void cacheAirports(const Value& data);
 
-	virtual string RestrictionsOutput(CFlightPlan flightPlan, const Value& sid_ele, bool check_type = true, bool check_time = true, bool check_ban = true, vector<size_t> successes = {});
+	virtual void serveCached();
 
-	virtual vector<vector<string>> RestrictionsSingle(const Value& restrictions, bool check_type = true, bool check_time = true, bool check_ban = true);
-	
-	virtual string SuffixOutput(CFlightPlan flightPlan, const Value& sid_ele, vector<size_t> successes = {});
+	virtual FlightPlanView readFlightPlan(CFlightPlan flightPlan);
 
-	virtual vector<string> SuffixSingle(const Value& restrictions);
+	virtual void readExtractedRoute(CFlightPlan flightPlan, FlightPlanView& view);
 
-	virtual string DirectionOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes);
+	virtual CheckKey getCheckKey(const FlightPlanView& view, const RuleSnapshot& rules);
 
-	virtual string MinMaxOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes);
+	virtual const CheckResult* getCheckResult(CFlightPlan flightPlan, RuleSnapshotPtr snapshot);
 
-	virtual string RouteOutput(CFlightPlan flightPlan, const Value& constraints, vector<size_t> successes, vector<string> extracted_route, string dest, int rfl, bool req_lvl = false);
+	virtual void collectChecks();
 
-	virtual string ExitPointOutput(CFlightPlan flightPlan, size_t origin_int, vector<string> extracted_route);
+	virtual void submitCheck(CFlightPlan flightPlan, FlightPlanView& view, const CheckKey& key, RuleSnapshotPtr snapshot, int minuteOfWeek);
 
-	virtual string DestinationOutput(CFlightPlan flightPlan, size_t origin_int, string dest);
+	virtual void prevalidate(RuleSnapshotPtr snapshot);
 
 	virtual void OnFunctionCall(int FunctionId, const char * ItemString, POINT Pt, RECT Area);
 
@@ -87,6 +92,12 @@ public:
 	//File name used for settings.
 	static constexpr const char* kConfigFileName = "vfpc_config.json";
 
+	virtual void OnFlightPlanFlightPlanDataUpdate(CFlightPlan FlightPlan);
+
+	virtual void OnFlightPlanControllerAssignedDataUpdate(CFlightPlan FlightPlan, int DataType);
+
+	virtual void OnFlightPlanDisconnect(CFlightPlan FlightPlan);
+
 	//Define OnGetTagItem function
 	virtual void OnGetTagItem(CFlightPlan FlightPlan,
 		CRadarTarget RadarTarget,
@@ -97,137 +108,6 @@ public:
 		COLORREF* pRGB,
 		double* pFontSize);
 
-	template <typename Out>
-	void split(const string& s, char delim, Out result) {
-		istringstream iss(s);
-		string item;
-		while (getline(iss, item, delim)) {
-			*result++ = item;
-		}
-	}
-
-	vector<string> split(const string& s, char delim) {
-		vector<string> elems;
-		split(s, delim, back_inserter(elems));
-		return elems;
-	}
-
-	string destArrayContains(const Value& a, string s) {
-		for (SizeType i = 0; i < a.Size(); i++) {
-			string test = a[i].GetString();
-			SizeType x = static_cast<rapidjson::SizeType>(s.rfind(test, 0));
-			if (s.rfind(a[i].GetString(), 0) != -1)
-				return a[i].GetString();
-		}
-		return "";
-	}
-
-	bool arrayContains(const Value& a, string s) {
-		for (SizeType i = 0; i < a.Size(); i++) {
-			if (a[i].GetString() == s)
-				return true;
-		}
-		return false;
-	}
-
-	bool arrayContainsEnding(const Value& a, string s) {
-		for (SizeType i = 0; i < a.Size(); i++) {
-			string comp = a[i].GetString();
-			int pos = s.size() - comp.size();
-			if (pos < 0)
-				continue;
-
-			bool valid = true;
-
-			for (SizeType i = 0; i < comp.size(); i++) {
-				if (comp[i] != s[pos + i])
-					valid = false;
-			}
-
-			if (valid)
-				return true;
-			
-		}
-		return false;
-	}
-
-	bool arrayContains(const Value& a, char s) {
-		for (SizeType i = 0; i < a.Size(); i++) {
-			if (a[i].GetString()[0] == s)
-				return true;
-		}
-		return false;
-	}
-
-	string arrayToString(const Value& a, char delimiter) {
-		string s;
-		for (SizeType i = 0; i < a.Size(); i++) {
-			s += a[i].GetString()[0];
-			if (i != a.Size() - 1)
-				s += delimiter;
-		}
-		return s;
-	}
-
-	bool routeContains(vector<string> rte, const Value& valid) {
-		for (SizeType i = 0; i < valid.Size(); i++) {
-			string r = valid[i].GetString();
-
-			if (!strcmp(r.c_str(), WILDCARD.c_str())) {
-				return true;
-			}
-
-			vector<string> current = split(r, ' ');
-			for (std::size_t j = 0; j < current.size(); j++) {
-				boost::to_upper(current[j]);
-			}
-
-			bool admissible = true;
-
-			if (current.size() > rte.size()) {
-				admissible = false;
-			}
-			else {
-				for (SizeType j = 0; j < current.size(); j++) {
-					if (current[j] != rte[j] && strcmp(current[j].c_str(), WILDCARD.c_str())) {
-						admissible = false;
-					}
-				}
-			}
-
-			if (admissible) {
-				return true;
-			}
-		}
-		return false;
-	}
-
-	string dayIntToString(int day) {
-		switch (day) {
-		case 0:
-			return "Monday";
-		case 1:
-			return "Tuesday";
-		case 2:
-			return "Wednesday";
-		case 3:
-			return "Thursday";
-		case 4:
-			return "Friday";
-		case 5:
-			return "Saturday";
-		case 6:
-			return "Sunday";
-		default:
-			return "Out of Range";
-		}
-	}
-
-	inline const char * const BoolToString(bool b)
-	{
-		return b ? "true" : "false";
-	}
-
 	virtual string getPath();
 
 	virtual bool OnCompileCommand(const char * sCommandLine);
@@ -248,7 +128,13 @@ public:
 
 	virtual void checkFPDetail();
 
-	virtual string getFails(CFlightPlan flightPlan, vector<string> messageBuffer, COLORREF* pRGB);
+	virtual void statsCommand(string args);
+
+	virtual bool dumpStats();
+
+	virtual void toggleTrace();
+
+	virtual const char* getFails(const CheckResult& result, COLORREF* pRGB);
 
 	virtual void runWebCalls();
 
@@ -257,15 +143,29 @@ public:
 	virtual bool WriteDefaultSettingsJson(const std::string& filename);
 private:
 	std::string base_url_ = "https://vfpc_config.json/";
+	bool per_airport_ = true; //Fetch each airport separately rather than in one combined request
 	int last_update = -1;
+	int statsDumpInterval = 0; //Seconds between dumps to STATS_FILE, 0 = off
+	int statsDumpCountdown = 0;
 
 protected:
 	Document config;
+	string configEndpoint; //API endpoint config was last parsed from - empty if loaded from file
+	HttpClient http;
+	TimeSource timeSource;
+	unsigned int fetchedGeneration = 0; //Generation of the last snapshot published by fetchAirports
 	vector<string> loadedAirports;
 	vector<string> activeAirports;
 	int *thisVersion;
 	vector<int> curVersion;
 	vector<int> minVersion;
-	map<string, rapidjson::SizeType> airports;
+	RuleStore ruleStore;
+	SidChecker checker;
+	ResultCache<CheckResult> checkResults;
+	LogWriter logWriter;
+	ValidationPool validator;
+	map<string, CheckKey> validating; //Callsigns submitted to validator, with the inputs they were submitted with
+	AirportCache airportCache;
+	set<string> cacheChecked; //Airports already looked up in airportCache
 };
 
@@ -0,0 +1,110 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/***********************************************************
+* Outcome of a flight plan check.
+*
+* validateSid records what happened at each stage and which
+* constraints survived; nothing is formatted. The tag item
+* code is read straight from the stage statuses, and the
+* explanatory sentences shown by "Show Checks" are built from
+* this on request only.
+***********************************************************/
+
+enum class SidStatus : unsigned char {
+	Found, //SID (or non-SID route) entry located
+	AirportNotFound,
+	NoSids,
+	SidRequired,
+	SidNotFound
+};
+
+enum class SyntaxError : unsigned char {
+	None,
+	NoRoute,
+	DifferentOrigin,
+	DifferentDestination,
+	InvalidSpeedLevelChange,
+	DirectSpeedLevel, //DCT/N0450F350 - reported without a reason, as before
+	NotFromFirstWaypoint
+};
+
+enum class StageStatus : unsigned char {
+	NotChecked,
+	Passed,
+	Warning,
+	Failed
+};
+
+//Stages in tag priority order
+enum CheckStage {
+	STAGE_DESTINATION,
+	STAGE_EXIT_POINT,
+	STAGE_ROUTE,
+	STAGE_LEVEL,
+	STAGE_DIRECTION,
+	STAGE_SUFFIX,
+	STAGE_RESTRICTIONS,
+	STAGE_WARNINGS,
+	STAGE_BANS,
+	STAGE_COUNT
+};
+
+struct CheckResult {
+	SidStatus sidStatus = SidStatus::AirportNotFound;
+	SyntaxError syntax = SyntaxError::None;
+	StageStatus stages[STAGE_COUNT] = {};
+	bool passed = false;
+
+	std::string sid; //SID as filed, '#' removed
+	size_t sidIndex = 0;
+	int round = 0; //First constraint round in which every constraint failed (7 = none)
+	bool sidwide = false; //SID-level restrictions passed
+	bool sidFails[4] = {}; //SID-level restriction failures: 0 = Suffix, 1 = Aircraft/Engines, 2 = Date/Time, 3 = Banned
+	bool restFails[4] = {}; //Constraint-level restriction failures, as above
+	std::vector<size_t> successes; //Constraints still valid when checking stopped
+	int windowChange = -1; //Minutes until a restriction window the check read opens or closes, -1 if none can
+};
+
+//Departure list code for a check result - the first failed stage, in priority order
+inline const char* resultCode(const CheckResult& result) {
+	static const char* const stageCodes[] = { "DST", "XPT", "RTE", "LVL", "OER", "SUF", "RST" };
+
+	if (result.syntax != SyntaxError::None) {
+		return "CHK";
+	}
+	else if (result.sidStatus != SidStatus::Found) {
+		return "SID";
+	}
+
+	for (int i = STAGE_DESTINATION; i <= STAGE_RESTRICTIONS; i++) {
+		if (result.stages[i] == StageStatus::Failed) {
+			return stageCodes[i];
+		}
+	}
+
+	//A warning takes precedence over a ban, as in the tag
+	if (result.stages[STAGE_WARNINGS] != StageStatus::Warning && result.stages[STAGE_BANS] == StageStatus::Failed) {
+		return "BAN";
+	}
+
+	return "OK!";
+}
+
+inline const char* syntaxErrorText(SyntaxError error) {
+	switch (error) {
+	case SyntaxError::NoRoute:
+		return "No Route";
+	case SyntaxError::DifferentOrigin:
+		return "Different Origin in Route";
+	case SyntaxError::DifferentDestination:
+		return "Different Destination in Route";
+	case SyntaxError::InvalidSpeedLevelChange:
+		return "Invalid Speed/Level Change";
+	case SyntaxError::NotFromFirstWaypoint:
+		return "Route Not From First Waypoint";
+	default:
+		return "";
+	}
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/***********************************************************
+* Word-packed set of candidate constraint indexes.
+*
+* validateSid starts with every constraint of the SID as a
+* candidate, and each round clears the ones it rules out.
+* Rounds visit only the surviving constraints, 64 at a time,
+* and the check stops as soon as a round would leave none.
+***********************************************************/
+
+//Index of the lowest set bit of a non-zero word
+inline int lowestBit(uint64_t word) {
+	static const int table[64] = {
+		0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+		62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+		63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+		46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+	};
+
+	//De Bruijn multiply - portable to 32-bit MSVC, which has no 64-bit bit scan
+	return table[((word & (0 - word)) * 0x03F79D71B4CB0A89ULL) >> 58];
+}
+
+class ConstraintSet {
+public:
+	ConstraintSet() {}
+
+	//Every index below count set, or none
+	explicit ConstraintSet(size_t count, bool value = true) {
+		assign(count, value);
+	}
+
+	void assign(size_t count, bool value = true) {
+		bits = count;
+		words.assign((count + 63) / 64, value ? ~0ULL : 0);
+		if (value && count % 64) {
+			words.back() = (1ULL << (count % 64)) - 1;
+		}
+	}
+
+	size_t size() const { return bits; }
+
+	bool test(size_t i) const {
+		return (words[i / 64] >> (i % 64) & 1) != 0;
+	}
+
+	void set(size_t i) {
+		words[i / 64] |= 1ULL << (i % 64);
+	}
+
+	void reset(size_t i) {
+		words[i / 64] &= ~(1ULL << (i % 64));
+	}
+
+	bool none() const {
+		for (uint64_t word : words) {
+			if (word) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//Sets of different sizes are treated as zero-extended
+	ConstraintSet& operator|=(const ConstraintSet& other) {
+		for (size_t i = 0; i < words.size() && i < other.words.size(); i++) {
+			words[i] |= other.words[i];
+		}
+		return *this;
+	}
+
+	ConstraintSet& operator&=(const ConstraintSet& other) {
+		for (size_t i = 0; i < words.size(); i++) {
+			words[i] &= i < other.words.size() ? other.words[i] : 0;
+		}
+		return *this;
+	}
+
+	//Removes every index in other
+	ConstraintSet& subtract(const ConstraintSet& other) {
+		for (size_t i = 0; i < words.size() && i < other.words.size(); i++) {
+			words[i] &= ~other.words[i];
+		}
+		return *this;
+	}
+
+	//Calls f(index) for every index in the set, in ascending order
+	template <typename F>
+	void forEach(F f) const {
+		for (size_t w = 0; w < words.size(); w++) {
+			uint64_t word = words[w];
+			while (word) {
+				f(w * 64 + lowestBit(word));
+				word &= word - 1;
+			}
+		}
+	}
+
+	//Clears every index for which keep(index) returns false
+	template <typename F>
+	void filter(F keep) {
+		for (size_t w = 0; w < words.size(); w++) {
+			uint64_t word = words[w];
+			while (word) {
+				int bit = lowestBit(word);
+				if (!keep(w * 64 + bit)) {
+					words[w] &= ~(1ULL << bit);
+				}
+				word &= word - 1;
+			}
+		}
+	}
+
+	std::vector<size_t> indexes() const {
+		std::vector<size_t> out{};
+		forEach([&out](size_t i) { out.push_back(i); });
+		return out;
+	}
+
+private:
+	friend struct RuleImageCodec; //Copies the words to and from a rule image as is
+
+	std::vector<uint64_t> words;
+	size_t bits = 0;
+};
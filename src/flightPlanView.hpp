@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/***********************************************************
+* The flight plan fields the checker reads.
+*
+* Filled once per check from whatever holds the flight plan -
+* the EuroScope API in the plugin, a file in the command line
+* tools - so the checker core has no EuroScope or Win32
+* dependency and never fetches the same field twice. Values
+* are as filed; the checker does its own upper-casing.
+***********************************************************/
+
+struct FlightPlanView {
+	std::string callsign;
+	std::string origin;
+	std::string destination;
+	std::string route;
+	std::string sid;
+	std::string planType; //"I", "V", ...
+	int rfl = 0; //Feet
+	char aircraftType = 0; //L = Landplane, H = Helicopter, ... (as EuroScope GetAircraftType)
+	char engineType = 0; //J = Jet, P = Piston, T = Turboprop, ...
+	std::vector<std::string> points; //Extracted route point names, in order
+};
@@ -0,0 +1,268 @@
+#include "httpClient.hpp"
+#include <curl/curl.h>
+#include <cstring>
+#include <cctype>
+
+using namespace std;
+
+//Responses remembered for conditional requests - one per airport fetched separately, or per distinct airport set
+static const size_t CACHE_ENTRIES = 64;
+
+static const long REQUEST_TIMEOUT = 10;
+
+static const int POLL_TIMEOUT_MS = 1000;
+
+HttpClient::HttpClient() : handle(curl_easy_init()), multi(curl_multi_init()) {
+}
+
+HttpClient::~HttpClient() {
+	for (void* each : pool) {
+		if (each) {
+			curl_easy_cleanup(static_cast<CURL*>(each));
+		}
+	}
+	if (multi) {
+		curl_multi_cleanup(static_cast<CURLM*>(multi));
+	}
+	if (handle) {
+		curl_easy_cleanup(static_cast<CURL*>(handle));
+	}
+}
+
+//Stores output of HTTP request in string, or passes it on to the transfer's sink
+size_t HttpClient::writeCallback(void* contents, size_t size, size_t nmemb, void* transfer) {
+	Transfer* out = static_cast<Transfer*>(transfer);
+
+	if (out->sink) {
+		(*out->sink)(static_cast<char*>(contents), size * nmemb);
+	}
+	else {
+		out->data.append(static_cast<char*>(contents), size * nmemb);
+	}
+	return size * nmemb;
+}
+
+//Picks the ETag and Last-Modified validators out of the response headers
+size_t HttpClient::headerCallback(char* buffer, size_t size, size_t nitems, void* entry) {
+	size_t len = size * nitems;
+	CacheEntry* out = static_cast<CacheEntry*>(entry);
+
+	//A new status line starts a new response (e.g. after a redirect)
+	if (len > 5 && strncmp(buffer, "HTTP/", 5) == 0) {
+		out->etag.clear();
+		out->lastModified.clear();
+		return len;
+	}
+
+	size_t colon = 0;
+	while (colon < len && buffer[colon] != ':') {
+		colon++;
+	}
+	if (colon == len) {
+		return len;
+	}
+
+	string name(buffer, colon);
+	for (char& c : name) {
+		c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	}
+
+	size_t start = colon + 1;
+	size_t end = len;
+	while (start < end && (buffer[start] == ' ' || buffer[start] == '\t')) {
+		start++;
+	}
+	while (end > start && (buffer[end - 1] == '\r' || buffer[end - 1] == '\n' || buffer[end - 1] == ' ')) {
+		end--;
+	}
+
+	if (name == "etag") {
+		out->etag.assign(buffer + start, end - start);
+	}
+	else if (name == "last-modified") {
+		out->lastModified.assign(buffer + start, end - start);
+	}
+
+	return len;
+}
+
+//Sets up a handle for a GET of url, adding validators if conditional
+void HttpClient::prepare(void* easy, const string& url, Transfer& transfer, bool conditional, const BodySink* sink) {
+	CURL* curl = static_cast<CURL*>(easy);
+
+	requests++;
+	transfer.sink = sink;
+
+	//A 304 to a streamed response has no body to hand back, so only a streamed request may get one
+	map<string, CacheEntry>::const_iterator cached = cache.find(url);
+	if (conditional && cached != cache.end() && (sink || !cached->second.streamed)) {
+		if (!cached->second.etag.empty()) {
+			transfer.headers = curl_slist_append(transfer.headers, ("If-None-Match: " + cached->second.etag).c_str());
+		}
+		if (!cached->second.lastModified.empty()) {
+			transfer.headers = curl_slist_append(transfer.headers, ("If-Modified-Since: " + cached->second.lastModified).c_str());
+		}
+	}
+
+	curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+	curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.headers);
+	curl_easy_setopt(curl, CURLOPT_TIMEOUT, REQUEST_TIMEOUT);
+	curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+	curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, ""); //Every encoding this libcurl can decode (gzip, deflate)
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
+	curl_easy_setopt(curl, CURLOPT_HEADERDATA, &transfer.response);
+}
+
+//Turns a completed transfer into a response, updating the validator cache
+HttpStatus HttpClient::finish(void* easy, const string& url, Transfer& transfer, int result, HttpResponse& out) {
+	CURL* curl = static_cast<CURL*>(easy);
+
+	long httpCode = 0;
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+
+	//Options must not point at freed memory between calls
+	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+	curl_slist_free_all(transfer.headers);
+	transfer.headers = nullptr;
+
+	if (CURLE_OK != result) {
+		out.error = curl_easy_strerror(static_cast<CURLcode>(result));
+		return out.status = HttpStatus::Failed;
+	}
+
+	map<string, CacheEntry>::iterator cached = cache.find(url);
+
+	if (httpCode == 304 && cached != cache.end()) {
+		cached->second.used = requests;
+		out.body = cached->second.body;
+		return out.status = HttpStatus::NotModified;
+	}
+
+	out.body = transfer.data;
+
+	//Error pages are passed on as before, but never used to answer a later 304
+	if (httpCode < 400 && (!transfer.response.etag.empty() || !transfer.response.lastModified.empty())) {
+		transfer.response.streamed = transfer.sink != nullptr;
+		transfer.response.body = std::move(transfer.data);
+		remember(url, transfer.response);
+	}
+	else if (cached != cache.end()) {
+		cache.erase(cached);
+	}
+
+	return out.status = HttpStatus::Ok;
+}
+
+HttpStatus HttpClient::get(const string& url, string& body, string& error, bool conditional) {
+	if (!handle) {
+		error = "CURL handle could not be created";
+		return HttpStatus::Failed;
+	}
+
+	Transfer transfer;
+	prepare(handle, url, transfer, conditional);
+
+	CURLcode result = curl_easy_perform(static_cast<CURL*>(handle));
+
+	HttpResponse response;
+	finish(handle, url, transfer, result, response);
+
+	body = std::move(response.body);
+	error = std::move(response.error);
+	return response.status;
+}
+
+void HttpClient::getAll(const vector<string>& urls, vector<HttpResponse>& out, bool conditional, const vector<BodySink>* sinks) {
+	out.assign(urls.size(), HttpResponse());
+
+	CURLM* curlm = static_cast<CURLM*>(multi);
+	if (!curlm) {
+		for (HttpResponse& each : out) {
+			each.error = "CURL multi handle could not be created";
+		}
+		return;
+	}
+
+	while (pool.size() < urls.size()) {
+		pool.push_back(curl_easy_init());
+	}
+
+	vector<Transfer> transfers(urls.size());
+	vector<int> results(urls.size(), CURLE_OK);
+	vector<bool> added(urls.size(), false);
+
+	for (size_t i = 0; i < urls.size(); i++) {
+		if (!pool[i]) {
+			out[i].error = "CURL handle could not be created";
+			continue;
+		}
+
+		prepare(pool[i], urls[i], transfers[i], conditional, sinks ? &(*sinks)[i] : nullptr);
+		curl_easy_setopt(static_cast<CURL*>(pool[i]), CURLOPT_PRIVATE, reinterpret_cast<char*>(i));
+		added[i] = (curl_multi_add_handle(curlm, static_cast<CURL*>(pool[i])) == CURLM_OK);
+
+		if (!added[i]) {
+			results[i] = CURLE_FAILED_INIT;
+		}
+	}
+
+	int running = 0;
+	CURLMcode code = curl_multi_perform(curlm, &running);
+	while (code == CURLM_OK && running > 0) {
+		code = curl_multi_poll(curlm, nullptr, 0, POLL_TIMEOUT_MS, nullptr);
+		if (code == CURLM_OK) {
+			code = curl_multi_perform(curlm, &running);
+		}
+	}
+
+	//Per-transfer outcome
+	int left = 0;
+	while (CURLMsg* message = curl_multi_info_read(curlm, &left)) {
+		if (message->msg == CURLMSG_DONE) {
+			char* index = nullptr;
+			curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &index);
+			results[reinterpret_cast<size_t>(index)] = message->data.result;
+		}
+	}
+
+	//The whole batch is abandoned if the multi handle itself failed
+	if (code != CURLM_OK) {
+		for (size_t i = 0; i < urls.size(); i++) {
+			if (added[i] && results[i] == CURLE_OK) {
+				results[i] = CURLE_RECV_ERROR;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < urls.size(); i++) {
+		if (!pool[i]) {
+			continue;
+		}
+
+		if (added[i]) {
+			curl_multi_remove_handle(curlm, static_cast<CURL*>(pool[i]));
+		}
+
+		finish(pool[i], urls[i], transfers[i], results[i], out[i]);
+	}
+}
+
+void HttpClient::remember(const string& url, CacheEntry& entry) {
+	entry.used = requests;
+
+	map<string, CacheEntry>::iterator it = cache.find(url);
+	if (it == cache.end() && cache.size() >= CACHE_ENTRIES) {
+		map<string, CacheEntry>::iterator oldest = cache.begin();
+		for (map<string, CacheEntry>::iterator each = cache.begin(); each != cache.end(); each++) {
+			if (each->second.used < oldest->second.used) {
+				oldest = each;
+			}
+		}
+		cache.erase(oldest);
+	}
+
+	cache[url] = std::move(entry);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+
+struct curl_slist;
+
+/***********************************************************
+* Keep-alive HTTP client for the API calls.
+*
+* CURL handles are kept for the plugin's lifetime, so the
+* connection (and TLS session) to the API server is reused
+* between polls instead of being set up every call. Responses
+* may be gzip/deflate compressed. getAll runs several requests
+* concurrently through one curl multi handle.
+*
+* Conditional requests: the ETag/Last-Modified validators and
+* body of recent responses are remembered per URL. When asked
+* to, the next request for that URL sends If-None-Match /
+* If-Modified-Since, and a 304 hands back the remembered body
+* as NotModified.
+*
+* getAll can hand bodies to a sink per request as they arrive
+* instead. Those bodies are not remembered, so only another
+* streamed request for the URL is made conditional, and its
+* caller must still have the data a 304 refers to.
+*
+* Not thread safe - only used from the web call worker.
+***********************************************************/
+
+enum class HttpStatus {
+	Ok,
+	NotModified,
+	Failed
+};
+
+//Receives the next chunk of a response body
+typedef std::function<void(const char* data, size_t size)> BodySink;
+
+struct HttpResponse {
+	HttpStatus status = HttpStatus::Failed;
+	std::string body; //Empty if streamed to a sink
+	std::string error; //Set on Failed
+};
+
+class HttpClient {
+public:
+	HttpClient();
+
+	~HttpClient();
+
+	//GETs url into body. error is set on Failed.
+	HttpStatus get(const std::string& url, std::string& body, std::string& error, bool conditional = false);
+
+	//GETs every url concurrently - out[i] is the response to urls[i]
+	//If sinks is passed, the body of urls[i] is written to (*sinks)[i] rather than out[i].body
+	void getAll(const std::vector<std::string>& urls, std::vector<HttpResponse>& out, bool conditional = false, const std::vector<BodySink>* sinks = nullptr);
+
+private:
+	struct CacheEntry {
+		std::string etag;
+		std::string lastModified;
+		std::string body;
+		bool streamed = false; //Validators only - the body went to a sink
+		unsigned long long used = 0;
+	};
+
+	//State of one request in flight
+	struct Transfer {
+		CacheEntry response;
+		std::string data;
+		curl_slist* headers = nullptr;
+		const BodySink* sink = nullptr;
+	};
+
+	static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* transfer);
+
+	static size_t headerCallback(char* buffer, size_t size, size_t nitems, void* entry);
+
+	void prepare(void* easy, const std::string& url, Transfer& transfer, bool conditional, const BodySink* sink = nullptr);
+
+	HttpStatus finish(void* easy, const std::string& url, Transfer& transfer, int result, HttpResponse& out);
+
+	void remember(const std::string& url, CacheEntry& entry);
+
+	void* handle; //CURL*, used by get
+	void* multi; //CURLM*, used by getAll
+	std::vector<void*> pool; //CURL* per concurrent getAll request, kept for connection reuse
+	std::map<std::string, CacheEntry> cache;
+	unsigned long long requests = 0;
+};
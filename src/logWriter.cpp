@@ -0,0 +1,160 @@
+#include "logWriter.hpp"
+#include "perfStats.hpp"
+#include <cstdio>
+#include <chrono>
+
+using namespace std;
+
+//Idle writer wake-up interval, so lines queued without a notify() still reach the file
+static const chrono::milliseconds WRITER_INTERVAL(1000);
+
+LogWriter::LogWriter(size_t capacity, size_t maxFileSize) : ring(capacity ? capacity : 1), maxFileSize(maxFileSize) {
+}
+
+LogWriter::~LogWriter() {
+	close();
+}
+
+bool LogWriter::open(const string& filePath) {
+	close();
+
+	path = filePath;
+	file.open(path.c_str(), ios::out | ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file << "Log: Cleared Successfully." << "\n";
+	file.flush();
+	fileSize = static_cast<size_t>(file.tellp());
+
+	lock_guard<mutex> guard(lock);
+	head = count = dropped = 0;
+	queued = written = 0;
+	stopping = false;
+	running = true;
+	writer = thread(&LogWriter::run, this);
+
+	return true;
+}
+
+void LogWriter::push(const string& line) {
+	lock_guard<mutex> guard(lock);
+
+	if (count == ring.size()) {
+		//Full - overwrite the oldest line
+		head = (head + 1) % ring.size();
+		count--;
+		dropped++;
+		written++;
+	}
+
+	ring[(head + count) % ring.size()] = line;
+	count++;
+	queued++;
+}
+
+void LogWriter::notify() {
+	wake.notify_one();
+}
+
+void LogWriter::flush() {
+	unique_lock<mutex> guard(lock);
+	if (!running) {
+		return;
+	}
+
+	unsigned long long target = queued;
+	wake.notify_one();
+	done.wait(guard, [this, target] { return written >= target || !running; });
+}
+
+void LogWriter::close() {
+	{
+		lock_guard<mutex> guard(lock);
+		if (!running) {
+			return;
+		}
+		stopping = true;
+	}
+
+	wake.notify_one();
+	writer.join();
+
+	{
+		lock_guard<mutex> guard(lock);
+		running = false;
+	}
+
+	done.notify_all();
+	file.close();
+}
+
+void LogWriter::run() {
+	traceRecorder().nameThread("Log Writer");
+
+	vector<string> batch{};
+	batch.reserve(ring.size());
+
+	unique_lock<mutex> guard(lock);
+
+	while (true) {
+		wake.wait_for(guard, WRITER_INTERVAL, [this] { return stopping || count > 0; });
+
+		bool last = stopping;
+		size_t lost = dropped;
+
+		while (count > 0) {
+			batch.push_back(std::move(ring[head]));
+			head = (head + 1) % ring.size();
+			count--;
+		}
+		dropped = 0;
+
+		//Write without holding the lock, so push() never waits on the disk
+		guard.unlock();
+		size_t taken = batch.size();
+		writeBatch(batch, lost);
+		guard.lock();
+
+		written += taken;
+		done.notify_all();
+
+		if (last && count == 0) {
+			break;
+		}
+	}
+}
+
+void LogWriter::writeBatch(vector<string>& batch, size_t lost) {
+	StatTimer timer(Metric::WriteLog);
+
+	if (lost) {
+		string note = "Log: " + to_string(lost) + " Lines Dropped (Buffer Full)";
+		file << note << "\n";
+		fileSize += note.size() + 1;
+	}
+
+	for (const string& line : batch) {
+		file << line << "\n";
+		fileSize += line.size() + 1;
+
+		if (fileSize > maxFileSize) {
+			rotate();
+		}
+	}
+
+	file.flush();
+	batch.clear();
+}
+
+void LogWriter::rotate() {
+	string old = path + ".1";
+
+	file.close();
+	remove(old.c_str());
+	rename(path.c_str(), old.c_str());
+
+	file.open(path.c_str(), ios::out | ios::trunc);
+	fileSize = 0;
+}
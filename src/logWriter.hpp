@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/***********************************************************
+* Append-only log sink.
+*
+* Lines are queued in a fixed-size ring buffer and written by
+* a background thread, so logging never touches the disk on
+* EuroScope's thread. When the file grows past the size
+* limit it is moved to "<name>.1" and a fresh file started.
+* If the writer falls behind, the oldest queued lines are
+* dropped and a note of how many is written in their place.
+***********************************************************/
+
+class LogWriter {
+public:
+	LogWriter(size_t capacity, size_t maxFileSize);
+
+	~LogWriter();
+
+	//Truncates the file at path and starts the writer thread
+	bool open(const std::string& path);
+
+	//Queues a line - never blocks on I/O
+	void push(const std::string& line);
+
+	//Wakes the writer to write out anything queued
+	void notify();
+
+	//Blocks until everything queued so far is on disk
+	void flush();
+
+	//Writes out anything queued and stops the writer thread
+	void close();
+
+private:
+	void run();
+
+	void writeBatch(std::vector<std::string>& batch, size_t dropped);
+
+	void rotate();
+
+	std::vector<std::string> ring;
+	size_t head = 0; //Oldest queued line
+	size_t count = 0;
+	size_t dropped = 0; //Lines lost to overflow since the last batch
+	unsigned long long queued = 0; //Total lines accepted
+	unsigned long long written = 0; //Total lines handed to the file
+
+	size_t maxFileSize;
+	std::string path;
+	std::ofstream file;
+	size_t fileSize = 0;
+
+	bool running = false;
+	bool stopping = false;
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable done;
+	std::thread writer;
+};
@@ -0,0 +1,113 @@
+#include "mappedFile.hpp"
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const string& path, string& error) {
+	close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		error = path + " Not Found";
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0 || static_cast<unsigned long long>(fileSize.QuadPart) > SIZE_MAX) {
+		CloseHandle(file);
+		error = path + " Empty Or Unreadable";
+		return false;
+	}
+
+	//The mapping keeps the file open, so the handle can go
+	HANDLE map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (!map) {
+		error = path + " Could Not Be Mapped";
+		return false;
+	}
+
+	const void* p = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+	if (!p) {
+		CloseHandle(map);
+		error = path + " Could Not Be Mapped";
+		return false;
+	}
+
+	mapping = map;
+	view = static_cast<const char*>(p);
+	length = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::close() {
+	if (view) {
+		UnmapViewOfFile(view);
+	}
+	if (mapping) {
+		CloseHandle(mapping);
+	}
+
+	view = nullptr;
+	mapping = nullptr;
+	length = 0;
+}
+
+#else
+
+bool MappedFile::open(const string& path, string& error) {
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		error = path + " Not Found";
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+		::close(fd);
+		error = path + " Empty Or Unreadable";
+		return false;
+	}
+
+	//The mapping keeps the file open, so the descriptor can go
+	void* p = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED) {
+		error = path + " Could Not Be Mapped";
+		return false;
+	}
+
+	view = static_cast<const char*>(p);
+	length = static_cast<size_t>(info.st_size);
+	return true;
+}
+
+void MappedFile::close() {
+	if (view) {
+		munmap(const_cast<char*>(view), length);
+	}
+
+	view = nullptr;
+	length = 0;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+/***********************************************************
+* Read-only memory mapping of a whole file.
+*
+* The pages come straight from the OS file cache, so nothing
+* is copied on open and every process mapping the same file
+* shares one copy of it.
+***********************************************************/
+
+class MappedFile {
+public:
+	MappedFile() {}
+
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//Maps path, unmapping any file mapped before. Returns false with error set if it cannot be mapped.
+	bool open(const std::string& path, std::string& error);
+
+	void close();
+
+	const char* data() const { return view; }
+
+	size_t size() const { return length; }
+
+private:
+	const char* view = nullptr;
+	size_t length = 0;
+	void* mapping = nullptr; //Mapping handle on Windows
+};
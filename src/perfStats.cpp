@@ -0,0 +1,165 @@
+#include "perfStats.hpp"
+#include <cstdio>
+
+using namespace std;
+
+const char* metricName(Metric metric) {
+	static const char* const names[] = {
+		"Tag Item",
+		"Validate SID",
+		"Round: Destination",
+		"Round: Exit Point",
+		"Round: Route",
+		"Round: Restrictions",
+		"Round: Min/Max Level",
+		"Round: Even/Odd Level",
+		"Round: Alerts",
+		"Explain Check",
+		"Output: Bans",
+		"Output: Warnings",
+		"Output: Alternatives",
+		"Output: Restrictions",
+		"Output: Suffix",
+		"Output: Even/Odd Level",
+		"Output: Min/Max Level",
+		"Output: Route",
+		"Output: Exit Point",
+		"Output: Destination",
+		"API Call",
+		"Version Call",
+		"Data Parse",
+		"Data Compile",
+		"Index Build",
+		"Cache Load",
+		"Cache Save",
+		"Image Load",
+		"Get SIDs",
+		"Web Calls",
+		"Timer Tick",
+		"Write Log"
+	};
+	static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(Metric::Count), "Every metric needs a name");
+
+	return names[static_cast<int>(metric)];
+}
+
+const char* metricCategory(Metric metric) {
+	if (metric < Metric::ApiCall) {
+		return "check";
+	}
+
+	return metric < Metric::WebCalls ? "data" : "plugin";
+}
+
+int LatencyHistogram::bucketOf(uint64_t ns) {
+	if (ns < 16) {
+		return static_cast<int>(ns);
+	}
+
+	int exponent = 63;
+	while (!(ns >> exponent)) {
+		exponent--;
+	}
+
+	int bucket = 16 + (exponent - 4) * 4 + static_cast<int>(ns >> (exponent - 2) & 3);
+	return bucket < BUCKETS ? bucket : BUCKETS - 1;
+}
+
+uint64_t LatencyHistogram::bucketTop(int bucket) {
+	if (bucket < 16) {
+		return static_cast<uint64_t>(bucket);
+	}
+
+	int exponent = (bucket - 16) / 4 + 4;
+	uint64_t sub = static_cast<uint64_t>((bucket - 16) % 4);
+	return (4 + sub + 1) * (1ULL << (exponent - 2)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+	buckets[bucketOf(ns)].fetch_add(1, memory_order_relaxed);
+	calls.fetch_add(1, memory_order_relaxed);
+	totalNs.fetch_add(ns, memory_order_relaxed);
+
+	uint64_t seen = maxNs.load(memory_order_relaxed);
+	while (ns > seen && !maxNs.compare_exchange_weak(seen, ns, memory_order_relaxed)) {
+	}
+}
+
+void LatencyHistogram::reset() {
+	for (atomic<uint64_t>& each : buckets) {
+		each.store(0, memory_order_relaxed);
+	}
+	calls.store(0, memory_order_relaxed);
+	totalNs.store(0, memory_order_relaxed);
+	maxNs.store(0, memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+	//Counts can move while we read - rank against the buckets' own sum
+	uint64_t counts[BUCKETS];
+	uint64_t sum = 0;
+	for (int i = 0; i < BUCKETS; i++) {
+		counts[i] = buckets[i].load(memory_order_relaxed);
+		sum += counts[i];
+	}
+
+	if (!sum) {
+		return 0;
+	}
+
+	uint64_t rank = static_cast<uint64_t>(q * (sum - 1)) + 1;
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKETS; i++) {
+		seen += counts[i];
+		if (seen >= rank) {
+			uint64_t top = bucketTop(i);
+			return top < max() ? top : max();
+		}
+	}
+
+	return max();
+}
+
+void PerfStats::reset() {
+	for (LatencyHistogram& each : histograms) {
+		each.reset();
+	}
+}
+
+//Nanoseconds as text in a readable unit
+static string duration(uint64_t ns) {
+	char buf[32];
+	if (ns < 10000) {
+		snprintf(buf, sizeof(buf), "%llu ns", static_cast<unsigned long long>(ns));
+	}
+	else if (ns < 10000000) {
+		snprintf(buf, sizeof(buf), "%.1f us", ns / 1e3);
+	}
+	else {
+		snprintf(buf, sizeof(buf), "%.1f ms", ns / 1e6);
+	}
+	return buf;
+}
+
+vector<string> PerfStats::report() const {
+	vector<string> out{};
+
+	for (int i = 0; i < static_cast<int>(Metric::Count); i++) {
+		const LatencyHistogram& h = histograms[i];
+		uint64_t calls = h.count();
+		if (!calls) {
+			continue;
+		}
+
+		out.push_back(string(metricName(static_cast<Metric>(i))) + ": " + to_string(calls) + " Calls, Total " + duration(h.total())
+			+ ", Mean " + duration(h.total() / calls) + ", p50 " + duration(h.percentile(0.5)) + ", p99 " + duration(h.percentile(0.99))
+			+ ", Max " + duration(h.max()));
+	}
+
+	return out;
+}
+
+PerfStats& perfStats() {
+	static PerfStats instance;
+	return instance;
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "traceRecorder.hpp"
+
+/***********************************************************
+* Hot path counters and latency histograms.
+*
+* Every instrumented section records into a fixed histogram
+* of atomic counters (log-linear buckets, 4 per power of two
+* of nanoseconds), so recording from the EuroScope thread,
+* the web call worker and the tools' worker threads never
+* takes a lock. Percentiles are read from the buckets, so
+* they are accurate to within a quarter of a power of two.
+*
+* Timing is off until enabled. A StatTimer also feeds the
+* trace recorder while it is started, and costs two relaxed
+* loads when neither is on.
+***********************************************************/
+
+enum class Metric : int {
+	TagItem,
+	ValidateSid,
+	RoundDestination,
+	RoundExitPoint,
+	RoundRoute,
+	RoundRestrictions,
+	RoundMinMax,
+	RoundDirection,
+	RoundAlerts,
+	ExplainCheck,
+	BansOutput,
+	WarningsOutput,
+	AlternativesOutput,
+	RestrictionsOutput,
+	SuffixOutput,
+	DirectionOutput,
+	MinMaxOutput,
+	RouteOutput,
+	ExitPointOutput,
+	DestinationOutput,
+	ApiCall,
+	VersionCall,
+	DataParse,
+	DataCompile,
+	IndexBuild,
+	CacheLoad,
+	CacheSave,
+	ImageLoad,
+	GetSids,
+	WebCalls,
+	Timer,
+	WriteLog,
+	Count
+};
+
+const char* metricName(Metric metric);
+
+//Trace event category: "check", "data" or "plugin"
+const char* metricCategory(Metric metric);
+
+//Metric of validateSid round 0 - 6
+inline Metric roundMetric(int round) {
+	return static_cast<Metric>(static_cast<int>(Metric::RoundDestination) + round);
+}
+
+class LatencyHistogram {
+public:
+	static const int BUCKETS = 16 + 44 * 4; //Exact below 16 ns, then 4 per power of two up to 2^48 ns (about 78 hours) - longer times land in the last bucket
+
+	void record(uint64_t ns);
+
+	void reset();
+
+	uint64_t count() const { return calls.load(std::memory_order_relaxed); }
+
+	uint64_t total() const { return totalNs.load(std::memory_order_relaxed); }
+
+	uint64_t max() const { return maxNs.load(std::memory_order_relaxed); }
+
+	//Upper bound of the bucket holding the q-th fraction of recorded values, in ns
+	uint64_t percentile(double q) const;
+
+private:
+	static int bucketOf(uint64_t ns);
+
+	static uint64_t bucketTop(int bucket);
+
+	std::atomic<uint64_t> buckets[BUCKETS] = {};
+	std::atomic<uint64_t> calls{ 0 };
+	std::atomic<uint64_t> totalNs{ 0 };
+	std::atomic<uint64_t> maxNs{ 0 };
+};
+
+class PerfStats {
+public:
+	void setEnabled(bool on) { enabledFlag.store(on, std::memory_order_relaxed); }
+
+	bool enabled() const { return enabledFlag.load(std::memory_order_relaxed); }
+
+	void record(Metric metric, uint64_t ns) { histograms[static_cast<int>(metric)].record(ns); }
+
+	const LatencyHistogram& get(Metric metric) const { return histograms[static_cast<int>(metric)]; }
+
+	void reset();
+
+	//One line per metric with calls: "Name: calls, total, mean, p50, p99, max"
+	std::vector<std::string> report() const;
+
+private:
+	std::atomic<bool> enabledFlag{ false };
+	LatencyHistogram histograms[static_cast<int>(Metric::Count)];
+};
+
+//Process-wide instance
+PerfStats& perfStats();
+
+//Records the time from construction to destruction against metric, and as a trace event, if either is enabled
+class StatTimer {
+public:
+	explicit StatTimer(Metric metric) : metric(metric), stats(perfStats().enabled()), trace(traceRecorder().active()) {
+		if (stats || trace) {
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	~StatTimer() {
+		stop();
+	}
+
+	//Records now rather than at the end of the scope
+	void stop() {
+		if (stats || trace) {
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+			if (stats) {
+				perfStats().record(metric, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+			}
+
+			if (trace) {
+				traceRecorder().complete(metricName(metric), metricCategory(metric), start, end);
+			}
+
+			stats = trace = false;
+		}
+	}
+
+	StatTimer(const StatTimer&) = delete;
+	StatTimer& operator=(const StatTimer&) = delete;
+
+private:
+	Metric metric;
+	bool stats;
+	bool trace;
+	std::chrono::steady_clock::time_point start;
+};
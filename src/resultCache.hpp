@@ -0,0 +1,211 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <unordered_map>
+#include "timeSource.hpp"
+
+/***********************************************************
+* Per-callsign cache of flight plan check results.
+*
+* An entry is only reused while every input the checker reads
+* is unchanged, so a stale result is never taken for a current
+* one even if an update callback is missed. The EuroScope
+* update callbacks mark entries stale, and a disconnect erases
+* them so memory follows the live traffic. Until a new result
+* is stored, last() still hands back the stale one, so a tag
+* can show it while the plan is checked again.
+*
+* Restriction windows make a result time dependent, so each
+* entry also records how many minutes it stays valid for (the
+* checker's windowChange). The boundaries are kept in a
+* min-heap: expire() pops only the entries whose window has
+* opened or closed and marks them stale, and lookups treat an
+* entry past its boundary as a miss in the meantime.
+*
+* Boundaries are counted on the cache's own minute count,
+* which only ever moves forwards with the minutes of the week
+* it is given - a clock set back counts as most of a week on,
+* so it expires everything rather than keep a stale result.
+***********************************************************/
+
+struct CheckKey {
+	std::string route;
+	std::string sid;
+	std::string origin;
+	std::string destination;
+	std::string planType;
+	int rfl = 0;
+	char aircraftType = 0;
+	char engineType = 0;
+	unsigned int generation = 0; //Rule data generation - bumped whenever the compiled SID data is replaced
+
+	bool operator==(const CheckKey& other) const {
+		return rfl == other.rfl
+			&& aircraftType == other.aircraftType
+			&& engineType == other.engineType
+			&& generation == other.generation
+			&& route == other.route
+			&& sid == other.sid
+			&& origin == other.origin
+			&& destination == other.destination
+			&& planType == other.planType;
+	}
+
+	bool operator!=(const CheckKey& other) const {
+		return !(*this == other);
+	}
+};
+
+template <typename Result>
+class ResultCache {
+public:
+	//Returns the stored result for callsign if it was computed from the same inputs and is still current at minuteOfWeek, else nullptr
+	const Result* find(const std::string& callsign, const CheckKey& key, int minuteOfWeek) {
+		advance(minuteOfWeek);
+
+		typename std::unordered_map<std::string, Entry>::const_iterator it = entries.find(callsign);
+		if (it == entries.end() || !current(it->second, key)) {
+			misses++;
+			return nullptr;
+		}
+
+		hits++;
+		return &it->second.result;
+	}
+
+	//Whether find would return the stored result for callsign - not counted as a lookup
+	bool holds(const std::string& callsign, const CheckKey& key, int minuteOfWeek) {
+		advance(minuteOfWeek);
+
+		typename std::unordered_map<std::string, Entry>::const_iterator it = entries.find(callsign);
+		return it != entries.end() && current(it->second, key);
+	}
+
+	//Last result stored for callsign, current or not, or nullptr if there is none - not counted as a lookup
+	const Result* last(const std::string& callsign) const {
+		typename std::unordered_map<std::string, Entry>::const_iterator it = entries.find(callsign);
+		return it != entries.end() ? &it->second.result : nullptr;
+	}
+
+	//Stores a result computed at minuteOfWeek that stays valid for validFor minutes, or -1 until its inputs change
+	const Result& store(const std::string& callsign, const CheckKey& key, const Result& result, int minuteOfWeek, int validFor) {
+		//Computed in the background a little while ago, or ahead of the last minute seen
+		int age = ((weekMinute - minuteOfWeek) % MINUTES_PER_WEEK + MINUTES_PER_WEEK) % MINUTES_PER_WEEK;
+		if (clock < 0 || age > MINUTES_PER_WEEK / 2) {
+			advance(minuteOfWeek);
+			age = 0;
+		}
+
+		Entry& entry = entries[callsign];
+		entry.key = key;
+		entry.result = result;
+		entry.stale = false;
+		entry.expires = validFor < 0 ? -1 : clock - age + validFor;
+
+		if (entry.expires >= 0) {
+			edges.push(Edge{ entry.expires, callsign });
+			compact();
+		}
+
+		return entry.result;
+	}
+
+	//Marks stale every entry whose restriction window has opened or closed by minuteOfWeek, appending their callsigns to out
+	void expire(int minuteOfWeek, std::vector<std::string>& out) {
+		advance(minuteOfWeek);
+
+		while (!edges.empty() && edges.top().due <= clock) {
+			typename std::unordered_map<std::string, Entry>::iterator it = entries.find(edges.top().callsign);
+
+			//Edges of replaced or dropped entries are left in the heap until they come up
+			if (it != entries.end() && !it->second.stale && it->second.expires == edges.top().due) {
+				out.push_back(it->first);
+				it->second.stale = true;
+			}
+
+			edges.pop();
+		}
+	}
+
+	//The inputs of callsign changed - its result is kept for last() but no longer found
+	void invalidate(const std::string& callsign) {
+		typename std::unordered_map<std::string, Entry>::iterator it = entries.find(callsign);
+		if (it != entries.end()) {
+			it->second.stale = true;
+		}
+	}
+
+	void erase(const std::string& callsign) {
+		entries.erase(callsign);
+	}
+
+	void clear() {
+		entries.clear();
+		edges = EdgeHeap();
+	}
+
+	size_t size() const { return entries.size(); }
+
+	//Restriction window boundaries waiting in the heap, including those of replaced entries
+	size_t pendingEdges() const { return edges.size(); }
+
+	unsigned long long hitCount() const { return hits; }
+
+	unsigned long long missCount() const { return misses; }
+
+private:
+	struct Entry {
+		CheckKey key;
+		Result result;
+		long long expires = -1; //Minute count the result goes stale at, -1 if never
+		bool stale = false; //Inputs changed or window crossed since - kept only for last()
+	};
+
+	struct Edge {
+		long long due;
+		std::string callsign;
+
+		bool operator>(const Edge& other) const { return due > other.due; }
+	};
+
+	typedef std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> EdgeHeap;
+
+	bool current(const Entry& entry, const CheckKey& key) const {
+		return !entry.stale && entry.key == key && (entry.expires < 0 || clock < entry.expires);
+	}
+
+	//Moves the minute count on to minuteOfWeek, never backwards
+	void advance(int minuteOfWeek) {
+		if (clock < 0) {
+			clock = 0;
+		}
+		else {
+			clock += ((minuteOfWeek - weekMinute) % MINUTES_PER_WEEK + MINUTES_PER_WEEK) % MINUTES_PER_WEEK;
+		}
+		weekMinute = minuteOfWeek;
+	}
+
+	//Rebuilds the heap from the live entries once replaced ones make up most of it
+	void compact() {
+		if (edges.size() <= 2 * entries.size() + 64) {
+			return;
+		}
+
+		EdgeHeap live;
+		for (const auto& each : entries) {
+			if (!each.second.stale && each.second.expires >= 0) {
+				live.push(Edge{ each.second.expires, each.first });
+			}
+		}
+		edges.swap(live);
+	}
+
+	std::unordered_map<std::string, Entry> entries;
+	EdgeHeap edges;
+	long long clock = -1; //Minutes counted since the first time seen
+	int weekMinute = 0; //Minute of the week clock was last moved to
+	unsigned long long hits = 0;
+	unsigned long long misses = 0;
+};
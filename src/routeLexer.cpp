@@ -0,0 +1,184 @@
+#include "routeLexer.hpp"
+
+static inline bool isUpper(char c) {
+	return c >= 'A' && c <= 'Z';
+}
+
+static inline bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+//Counts the run of digits starting at i
+static size_t digitRun(const char* p, size_t n, size_t i) {
+	size_t start = i;
+	while (i < n && isDigit(p[i])) {
+		i++;
+	}
+	return i - start;
+}
+
+//(N|M|K)[0-9]{3,4}
+static bool lexSpeed(const char* p, size_t n, size_t& i) {
+	if (i >= n || (p[i] != 'N' && p[i] != 'M' && p[i] != 'K')) {
+		return false;
+	}
+
+	size_t digits = digitRun(p, n, i + 1);
+	if (digits < 3 || digits > 4) {
+		return false;
+	}
+
+	i += 1 + digits;
+	return true;
+}
+
+//(A|F)[0-9]{3}|(S|M)[0-9]{4}
+static bool lexLevel(const char* p, size_t n, size_t& i) {
+	if (i >= n) {
+		return false;
+	}
+
+	size_t digits;
+	if (p[i] == 'A' || p[i] == 'F') {
+		digits = 3;
+	}
+	else if (p[i] == 'S' || p[i] == 'M') {
+		digits = 4;
+	}
+	else {
+		return false;
+	}
+
+	if (n - i - 1 < digits) {
+		return false;
+	}
+
+	for (size_t j = 1; j <= digits; j++) {
+		if (!isDigit(p[i + j])) {
+			return false;
+		}
+	}
+
+	i += 1 + digits;
+	return true;
+}
+
+//(/[0-9]{2}(L|C|R)?)? then end of token
+static bool lexRunwayToEnd(const char* p, size_t n, size_t i) {
+	if (i == n) {
+		return true;
+	}
+
+	if (p[i] != '/' || n - i < 3 || !isDigit(p[i + 1]) || !isDigit(p[i + 2])) {
+		return false;
+	}
+
+	i += 3;
+	if (i < n && (p[i] == 'L' || p[i] == 'C' || p[i] == 'R')) {
+		i++;
+	}
+
+	return i == n;
+}
+
+//(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4})
+static bool isSpeedLevel(const char* p, size_t n, size_t i) {
+	return lexSpeed(p, n, i) && lexLevel(p, n, i) && i == n;
+}
+
+//[A-Z]{4}(/[0-9]{2}(L|C|R)?)?
+static bool isIcaoRunway(const char* p, size_t n) {
+	if (n < 4) {
+		return false;
+	}
+
+	for (size_t i = 0; i < 4; i++) {
+		if (!isUpper(p[i])) {
+			return false;
+		}
+	}
+
+	return lexRunwayToEnd(p, n, 4);
+}
+
+//[A-Z]{2,5}[0-9][A-Z](/[0-9]{2}(L|C|R)?)?
+static bool isSidStarRunway(const char* p, size_t n) {
+	size_t i = 0;
+	while (i < n && isUpper(p[i])) {
+		i++;
+	}
+
+	if (i < 2 || i > 5 || n - i < 2 || !isDigit(p[i]) || !isUpper(p[i + 1])) {
+		return false;
+	}
+
+	return lexRunwayToEnd(p, n, i + 2);
+}
+
+//[A-Z][0-9]{1,3}([A-Z])? starting at i
+static bool isAirwayBody(const char* p, size_t n, size_t i) {
+	if (i >= n || !isUpper(p[i])) {
+		return false;
+	}
+
+	size_t digits = digitRun(p, n, i + 1);
+	if (digits < 1 || digits > 3) {
+		return false;
+	}
+
+	i += 1 + digits;
+	if (i < n && isUpper(p[i])) {
+		i++;
+	}
+
+	return i == n;
+}
+
+//(U)?[A-Z][0-9]{1,3}([A-Z])?
+static bool isAirway(const char* p, size_t n) {
+	return isAirwayBody(p, n, 0) || (n && p[0] == 'U' && isAirwayBody(p, n, 1));
+}
+
+//Text from the first '/' matches /(N|M|K)[0-9]{3,4}(level)(level)?
+static bool isSpeedLevelChange(const char* p, size_t n) {
+	size_t i = 0;
+	while (i < n && p[i] != '/') {
+		i++;
+	}
+
+	if (i == n) {
+		return false;
+	}
+
+	i++;
+	if (!lexSpeed(p, n, i) || !lexLevel(p, n, i)) {
+		return false;
+	}
+
+	return i == n || (lexLevel(p, n, i) && i == n);
+}
+
+unsigned classifyRouteToken(const char* token, size_t len) {
+	unsigned out = TOKEN_WAYPOINT;
+
+	if (isSpeedLevel(token, len, 0)) {
+		out |= TOKEN_SPDLVL;
+	}
+	if (isSidStarRunway(token, len)) {
+		out |= TOKEN_SIDSTAR_RWY;
+	}
+	if (isIcaoRunway(token, len)) {
+		out |= TOKEN_ICAO_RWY;
+	}
+	if (len > 4 && token[0] == 'D' && token[1] == 'C' && token[2] == 'T' && token[3] == '/' && isSpeedLevel(token, len, 4)) {
+		out |= TOKEN_DCT_SPDLVL;
+	}
+	if (isAirway(token, len)) {
+		out |= TOKEN_AIRWAY;
+	}
+	if (isSpeedLevelChange(token, len)) {
+		out |= TOKEN_SPDLVL_CHANGE;
+	}
+
+	return out;
+}
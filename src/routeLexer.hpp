@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+
+/***********************************************************
+* Route token classification.
+*
+* Replaces the std::regex patterns validateSid used to build
+* on every call. Each token is scanned once, without
+* allocating, and the result is a mask of every class the
+* token belongs to - a token may match several (e.g. "EGLL"
+* is an ICAO code, "L9" an airway). A token with no class
+* bits is treated as a waypoint.
+***********************************************************/
+
+const unsigned TOKEN_WAYPOINT = 0x00;
+const unsigned TOKEN_SPDLVL = 0x01; //N0450F350, M082F370, K0830S1130
+const unsigned TOKEN_SIDSTAR_RWY = 0x02; //CPT3G, BPK7F/27R
+const unsigned TOKEN_ICAO_RWY = 0x04; //EGLL, EGLL/27L
+const unsigned TOKEN_DCT_SPDLVL = 0x08; //DCT/N0450F350
+const unsigned TOKEN_AIRWAY = 0x10; //L9, UL620, M145, Q41A
+const unsigned TOKEN_SPDLVL_CHANGE = 0x20; //Waypoint with speed/level change - LAM/N0450F350, LAM/N0450F350F390
+
+//Classifies a single (upper case) route token
+unsigned classifyRouteToken(const char* token, size_t len);
+
+inline unsigned classifyRouteToken(const std::string& token) {
+	return classifyRouteToken(token.c_str(), token.size());
+}
@@ -0,0 +1,540 @@
+#include "ruleImage.hpp"
+#include "mappedFile.hpp"
+#include "perfStats.hpp"
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <fstream>
+#include <cstring>
+
+using namespace std;
+
+static const char IMAGE_MAGIC[8] = { 'V', 'F', 'P', 'C', 'R', 'U', 'L', 'E' };
+static const uint32_t IMAGE_BYTE_ORDER = 0x01020304;
+static const size_t HEADER_WORDS = 7; //Magic (2), version, byte order, total words, string count, airport count
+
+//Appends words, storing each distinct string once
+class ImageWriter {
+public:
+	static const bool reading = false;
+
+	void word(uint32_t& v) { words.push_back(v); }
+
+	void text(string& s) {
+		unordered_map<string, uint32_t>::const_iterator it = ids.find(s);
+		uint32_t id = it != ids.end() ? it->second : static_cast<uint32_t>(strings.size());
+
+		if (it == ids.end()) {
+			strings.push_back(s);
+			ids.insert(make_pair(s, id));
+		}
+		words.push_back(id);
+	}
+
+	bool fits(uint32_t) { return true; }
+
+	void fail() {}
+
+	bool ok() const { return true; }
+
+	vector<uint32_t> words;
+	vector<string> strings;
+
+private:
+	unordered_map<string, uint32_t> ids;
+};
+
+//Reads one airport record back, failing rather than reading past the end of the image
+class ImageReader {
+public:
+	static const bool reading = true;
+
+	ImageReader(const char* data, size_t end, size_t pos, size_t stringCount, const char* chars)
+		: data(data), end(end), pos(pos), stringCount(stringCount), chars(chars) {}
+
+	void word(uint32_t& v) {
+		if (pos >= end) {
+			failed = true;
+			v = 0;
+			return;
+		}
+
+		memcpy(&v, data + pos * 4, 4);
+		pos++;
+	}
+
+	void text(string& s) {
+		uint32_t id = 0;
+		word(id);
+		if (id >= stringCount) {
+			failed = true;
+			return;
+		}
+
+		//Offsets were checked to be in order and in range when the image was opened
+		uint32_t range[2];
+		memcpy(range, data + (HEADER_WORDS + id) * 4, 8);
+		s.assign(chars + range[0], range[1] - range[0]);
+	}
+
+	//Whether count more elements could still be in the record - every element takes at least a word
+	bool fits(uint32_t count) {
+		if (count > end - pos) {
+			failed = true;
+		}
+		return !failed;
+	}
+
+	void fail() { failed = true; }
+
+	bool ok() const { return !failed; }
+
+private:
+	const char* data;
+	size_t end; //Words in the image
+	size_t pos;
+	size_t stringCount;
+	const char* chars;
+	bool failed = false;
+};
+
+//Moves every compiled struct through an ImageWriter or ImageReader field by field, so both directions share one layout
+struct RuleImageCodec {
+	template <typename A>
+	static void io(A& a, uint32_t& v) {
+		a.word(v);
+	}
+
+	template <typename A>
+	static void io(A& a, int& v) {
+		uint32_t w = static_cast<uint32_t>(v);
+		a.word(w);
+		v = static_cast<int>(w);
+	}
+
+	template <typename A>
+	static void io(A& a, bool& v) {
+		uint32_t w = v ? 1 : 0;
+		a.word(w);
+		v = w != 0;
+	}
+
+	template <typename A>
+	static void io(A& a, uint64_t& v) {
+		uint32_t low = static_cast<uint32_t>(v);
+		uint32_t high = static_cast<uint32_t>(v >> 32);
+		a.word(low);
+		a.word(high);
+		v = static_cast<uint64_t>(high) << 32 | low;
+	}
+
+	template <typename A>
+	static void io(A& a, string& v) {
+		a.text(v);
+	}
+
+	template <typename A, typename T>
+	static void io(A& a, vector<T>& v) {
+		uint32_t count = static_cast<uint32_t>(v.size());
+		a.word(count);
+		if (A::reading) {
+			if (!a.fits(count)) {
+				return;
+			}
+			v.resize(count);
+		}
+
+		for (T& each : v) {
+			io(a, each);
+			if (!a.ok()) {
+				return;
+			}
+		}
+	}
+
+	template <typename A, typename K, typename V>
+	static void io(A& a, unordered_map<K, V>& m) {
+		uint32_t count = static_cast<uint32_t>(m.size());
+		a.word(count);
+
+		if (A::reading) {
+			if (!a.fits(count)) {
+				return;
+			}
+
+			m.reserve(count);
+			for (uint32_t i = 0; i < count && a.ok(); i++) {
+				K key{};
+				V value{};
+				io(a, key);
+				io(a, value);
+				m.insert(make_pair(std::move(key), std::move(value)));
+			}
+			return;
+		}
+
+		//Sorted, so the same rules always give the same image
+		vector<K> keys{};
+		for (const auto& each : m) {
+			keys.push_back(each.first);
+		}
+		sort(keys.begin(), keys.end());
+
+		for (K& key : keys) {
+			io(a, key);
+			io(a, m.find(key)->second);
+		}
+	}
+
+	template <typename A>
+	static void io(A& a, ConstraintSet& v) {
+		uint32_t bits = static_cast<uint32_t>(v.bits);
+		a.word(bits);
+		v.bits = bits;
+		io(a, v.words);
+
+		if (A::reading && v.words.size() != (v.bits + 63) / 64) {
+			a.fail();
+		}
+	}
+
+	template <typename A>
+	static void io(A& a, WeekWindow& v) {
+		io(a, v.words);
+
+		if (A::reading && v.words.size() && v.words.size() != (WeekWindow::MINUTES + 63) / 64) {
+			a.fail();
+		}
+	}
+
+	template <typename A>
+	static void io(A& a, RestrictionRule& v) {
+		io(a, v.suffix);
+		io(a, v.types);
+		io(a, v.typeInitials);
+		io(a, v.hasWindow);
+		io(a, v.hasDate);
+		io(a, v.hasTime);
+		io(a, v.startDate);
+		io(a, v.endDate);
+		io(a, v.startTime);
+		io(a, v.endTime);
+		io(a, v.startTimeText);
+		io(a, v.endTimeText);
+		io(a, v.window);
+		io(a, v.banned);
+		io(a, v.sidLevel);
+		io(a, v.alt);
+	}
+
+	template <typename A>
+	static void io(A& a, AlertRule& v) {
+		io(a, v.ban);
+		io(a, v.warn);
+		io(a, v.hasSrd);
+		io(a, v.srd);
+		io(a, v.hasNote);
+		io(a, v.note);
+	}
+
+	template <typename A>
+	static void io(A& a, RoutePattern& v) {
+		io(a, v.matchAll);
+		io(a, v.tokens);
+	}
+
+	template <typename A>
+	static void io(A& a, ConstraintRule& v) {
+		io(a, v.dests);
+		io(a, v.nodests);
+		io(a, v.points);
+		io(a, v.nopoints);
+		io(a, v.pointsIsArray);
+		io(a, v.nopointsIsArray);
+		io(a, v.route);
+		io(a, v.noroute);
+		io(a, v.routeText);
+		io(a, v.norouteText);
+		io(a, v.routeIsArray);
+		io(a, v.norouteIsArray);
+		io(a, v.hasMin);
+		io(a, v.minIsInt);
+		io(a, v.min);
+		io(a, v.hasMax);
+		io(a, v.maxIsInt);
+		io(a, v.max);
+
+		uint32_t dir = static_cast<uint32_t>(v.dir);
+		a.word(dir);
+		v.dir = static_cast<LevelDirection>(dir);
+		if (dir > static_cast<uint32_t>(LevelDirection::Other)) {
+			a.fail();
+		}
+
+		io(a, v.restrictions);
+		io(a, v.alerts);
+	}
+
+	template <typename A>
+	static void io(A& a, RouteTrie::Node& v) {
+		io(a, v.children);
+		io(a, v.wildcard);
+		io(a, v.ends);
+	}
+
+	//count is the number of constraints the trie's patterns belong to
+	template <typename A>
+	static void io(A& a, RouteTrie& v, size_t count) {
+		io(a, v.nodes);
+		if (!A::reading || !a.ok()) {
+			return;
+		}
+
+		//match walks node links and sets constraint bits without checking them
+		if (v.nodes.empty()) {
+			a.fail();
+		}
+		for (const RouteTrie::Node& node : v.nodes) {
+			if (node.wildcard != RouteTrie::NO_NODE && node.wildcard >= v.nodes.size()) {
+				a.fail();
+			}
+			for (const auto& child : node.children) {
+				if (child.second >= v.nodes.size()) {
+					a.fail();
+				}
+			}
+			for (uint32_t end : node.ends) {
+				if (end >= count) {
+					a.fail();
+				}
+			}
+		}
+	}
+
+	template <typename A>
+	static void io(A& a, SidIndex& v, size_t count) {
+		io(a, v.anyDest);
+		io(a, v.dests);
+		io(a, v.nodests);
+		io(a, v.anyPoint);
+		io(a, v.points);
+		io(a, v.nopoints);
+		io(a, v.anyRoute);
+		io(a, v.route, count);
+		io(a, v.noroute, count);
+		if (!A::reading || !a.ok()) {
+			return;
+		}
+
+		//The rounds combine these with sets of every constraint
+		bool sized = v.anyDest.size() == count && v.anyPoint.size() == count && v.anyRoute.size() == count;
+		for (const auto* index : { &v.dests, &v.nodests }) {
+			for (const auto& each : *index) {
+				sized = sized && each.second.size() == count;
+			}
+		}
+		for (const auto* index : { &v.points, &v.nopoints }) {
+			for (const auto& each : *index) {
+				sized = sized && each.second.size() == count;
+			}
+		}
+		if (!sized) {
+			a.fail();
+		}
+	}
+
+	template <typename A>
+	static void io(A& a, SidRule& v) {
+		io(a, v.hasPoint);
+		io(a, v.point);
+		io(a, v.aliases);
+		io(a, v.hasConstraints);
+		io(a, v.restrictions);
+		io(a, v.constraints);
+		io(a, v.index, v.constraints.size());
+	}
+
+	template <typename A>
+	static void io(A& a, AirportRules& v) {
+		io(a, v.icao);
+
+		//Pool strings in id order - interning them again gives back the same ids
+		uint32_t count = static_cast<uint32_t>(v.pool.size());
+		a.word(count);
+		if (A::reading && !a.fits(count)) {
+			return;
+		}
+		for (uint32_t i = 0; i < count && a.ok(); i++) {
+			string s = A::reading ? string() : v.pool.str(i);
+			io(a, s);
+			if (A::reading && v.pool.intern(s) != i) {
+				a.fail();
+			}
+		}
+
+		io(a, v.sids);
+
+		//Lookup values are size_t, which is uint32_t itself on 32-bit builds
+		uint32_t names = static_cast<uint32_t>(v.sidLookup.size());
+		a.word(names);
+		if (A::reading) {
+			if (!a.fits(names)) {
+				return;
+			}
+
+			for (uint32_t i = 0; i < names && a.ok(); i++) {
+				string name;
+				uint32_t sid = 0;
+				io(a, name);
+				a.word(sid);
+				if (sid >= v.sids.size()) {
+					a.fail();
+				}
+				v.sidLookup.insert(make_pair(name, static_cast<size_t>(sid)));
+			}
+			return;
+		}
+
+		vector<string> keys{};
+		for (const auto& each : v.sidLookup) {
+			keys.push_back(each.first);
+		}
+		sort(keys.begin(), keys.end());
+
+		for (string& name : keys) {
+			uint32_t sid = static_cast<uint32_t>(v.sidLookup.find(name)->second);
+			io(a, name);
+			a.word(sid);
+		}
+	}
+};
+
+void writeRuleImage(const RuleSnapshot& rules, string& image) {
+	ImageWriter writer;
+	vector<uint32_t> offsets{}; //Into writer.words until the sections before are laid out
+
+	for (const auto& each : rules.airports) {
+		offsets.push_back(static_cast<uint32_t>(writer.words.size()));
+		RuleImageCodec::io(writer, const_cast<AirportRules&>(*each.second));
+	}
+
+	vector<uint32_t> stringOffsets{ 0 };
+	string chars;
+	for (const string& s : writer.strings) {
+		chars += s;
+		stringOffsets.push_back(static_cast<uint32_t>(chars.size()));
+	}
+	chars.resize((chars.size() + 3) / 4 * 4, '\0');
+
+	size_t airportsStart = HEADER_WORDS + stringOffsets.size() + chars.size() / 4 + offsets.size();
+	size_t total = airportsStart + writer.words.size();
+
+	vector<uint32_t> header(HEADER_WORDS);
+	memcpy(header.data(), IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+	header[2] = RULE_IMAGE_VERSION;
+	header[3] = IMAGE_BYTE_ORDER;
+	header[4] = static_cast<uint32_t>(total);
+	header[5] = static_cast<uint32_t>(writer.strings.size());
+	header[6] = static_cast<uint32_t>(offsets.size());
+
+	for (uint32_t& offset : offsets) {
+		offset += static_cast<uint32_t>(airportsStart);
+	}
+
+	image.clear();
+	image.reserve(total * 4);
+	image.append(reinterpret_cast<const char*>(header.data()), header.size() * 4);
+	image.append(reinterpret_cast<const char*>(stringOffsets.data()), stringOffsets.size() * 4);
+	image.append(chars);
+	image.append(reinterpret_cast<const char*>(offsets.data()), offsets.size() * 4);
+	image.append(reinterpret_cast<const char*>(writer.words.data()), writer.words.size() * 4);
+}
+
+bool readRuleImage(const char* data, size_t size, RuleSnapshot& out, string& error) {
+	StatTimer timer(Metric::ImageLoad);
+
+	uint32_t header[HEADER_WORDS];
+	if (size < sizeof(header) || memcmp(data, IMAGE_MAGIC, sizeof(IMAGE_MAGIC))) {
+		error = "Not A VFPC Rule Image";
+		return false;
+	}
+	memcpy(header, data, sizeof(header));
+
+	if (header[3] != IMAGE_BYTE_ORDER) {
+		error = "Rule Image Written With Other Byte Order";
+		return false;
+	}
+
+	if (header[2] != RULE_IMAGE_VERSION) {
+		error = "Rule Image Version " + to_string(header[2]) + " (Expected " + to_string(RULE_IMAGE_VERSION) + ") - Convert The Data Again";
+		return false;
+	}
+
+	size_t total = header[4];
+	size_t stringCount = header[5];
+	size_t airportCount = header[6];
+
+	if (size % 4 || total != size / 4 || stringCount >= total || HEADER_WORDS + stringCount + 1 > total) {
+		error = "Rule Image Truncated";
+		return false;
+	}
+
+	//String offsets must run in order and stay within the bytes that follow them
+	const size_t charsStart = HEADER_WORDS + stringCount + 1;
+	vector<uint32_t> stringOffsets(stringCount + 1);
+	memcpy(stringOffsets.data(), data + HEADER_WORDS * 4, stringOffsets.size() * 4);
+
+	size_t charWords = (static_cast<size_t>(stringOffsets.back()) + 3) / 4;
+	if (stringOffsets.front() != 0 || !is_sorted(stringOffsets.begin(), stringOffsets.end()) || charsStart + charWords + airportCount > total) {
+		error = "Rule Image String Table Damaged";
+		return false;
+	}
+
+	const size_t offsetsStart = charsStart + charWords;
+	const size_t airportsStart = offsetsStart + airportCount;
+
+	for (size_t i = 0; i < airportCount; i++) {
+		uint32_t offset;
+		memcpy(&offset, data + (offsetsStart + i) * 4, 4);
+		if (offset < airportsStart || offset >= total) {
+			error = "Rule Image Airport Table Damaged";
+			return false;
+		}
+
+		ImageReader reader(data, total, offset, stringCount, data + charsStart * 4);
+		shared_ptr<AirportRules> rules = make_shared<AirportRules>();
+		RuleImageCodec::io(reader, *rules);
+
+		if (!reader.ok()) {
+			error = "Rule Image Damaged (Airport " + to_string(i) + ")";
+			return false;
+		}
+
+		out.airports.insert(make_pair(rules->icao, rules));
+	}
+
+	return true;
+}
+
+bool loadRuleImage(const string& path, RuleSnapshot& out, string& error) {
+	MappedFile file;
+	if (!file.open(path, error)) {
+		return false;
+	}
+
+	return readRuleImage(file.data(), file.size(), out, error);
+}
+
+bool saveRuleImage(const RuleSnapshot& rules, const string& path, string& error) {
+	string image;
+	writeRuleImage(rules, image);
+
+	ofstream out(path.c_str(), ios::binary | ios::trunc);
+	out.write(image.data(), image.size());
+	if (!out) {
+		error = path + " Not Writable";
+		return false;
+	}
+
+	return true;
+}
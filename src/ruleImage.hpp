@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "ruleSnapshot.hpp"
+
+/***********************************************************
+* Binary image of compiled SID rule data.
+*
+* Holds every AirportRules exactly as compileAirport left it,
+* indexes, route tries and time window bitmaps included, so
+* loading it is a bounds-checked copy with no JSON parsing
+* and no index building. vfpc-pack writes one from Sid.json
+* or a saved API response.
+*
+* Layout (little-endian 32-bit words):
+*   header   "VFPCRULE", version, 0x01020304 (byte order),
+*            total words, string count, airport count
+*   strings  string count + 1 byte offsets, then the bytes,
+*            zero padded to a whole word - every string in
+*            the image is stored once and referred to by index
+*   offsets  word offset of each airport's record, so a single
+*            airport can be read without the others
+*   airports records of words, 64-bit values as low then high
+*
+* The version is bumped whenever a compiled struct changes,
+* and an image of any other version is refused.
+***********************************************************/
+
+const uint32_t RULE_IMAGE_VERSION = 1;
+
+//Serialises every airport of rules into image
+void writeRuleImage(const RuleSnapshot& rules, std::string& image);
+
+//Rebuilds the airports of an image into out. Returns false with error set if the image is damaged or of another version.
+bool readRuleImage(const char* data, size_t size, RuleSnapshot& out, std::string& error);
+
+//Maps and reads an image file
+bool loadRuleImage(const std::string& path, RuleSnapshot& out, std::string& error);
+
+//Writes rules to an image file
+bool saveRuleImage(const RuleSnapshot& rules, const std::string& path, std::string& error);
@@ -0,0 +1,610 @@
+#include "ruleModel.hpp"
+#include "perfStats.hpp"
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+using namespace rapidjson;
+
+static const string WILDCARD_TOKEN = "*";
+static const string EVEN_DIR = "EVEN";
+static const string ODD_DIR = "ODD";
+
+StringId StringPool::intern(const string& s) {
+	unordered_map<string, StringId>::const_iterator it = ids.find(s);
+	if (it != ids.end()) {
+		return it->second;
+	}
+
+	StringId id = static_cast<StringId>(strings.size());
+	strings.push_back(s);
+	ids.insert(pair<string, StringId>(s, id));
+	return id;
+}
+
+StringId StringPool::find(const string& s) const {
+	unordered_map<string, StringId>::const_iterator it = ids.find(s);
+	if (it != ids.end()) {
+		return it->second;
+	}
+
+	return NO_STRING_ID;
+}
+
+const string& StringPool::str(StringId id) const {
+	static const string empty = "";
+	static const string wildcard = WILDCARD_TOKEN;
+
+	if (id == WILDCARD_ID) {
+		return wildcard;
+	}
+	if (id >= strings.size()) {
+		return empty;
+	}
+
+	return strings[id];
+}
+
+static bool isArray(const Value& parent, const char* name) {
+	return parent.IsObject() && parent.HasMember(name) && parent[name].IsArray();
+}
+
+//Copies the string entries of an array member (missing/non-array members give an empty list)
+static vector<string> stringArray(const Value& parent, const char* name) {
+	vector<string> out{};
+
+	if (isArray(parent, name)) {
+		const Value& a = parent[name];
+		for (SizeType i = 0; i < a.Size(); i++) {
+			if (a[i].IsString()) {
+				out.push_back(a[i].GetString());
+			}
+		}
+	}
+
+	return out;
+}
+
+static vector<StringId> idArray(const Value& parent, const char* name, StringPool& pool) {
+	vector<StringId> out{};
+
+	for (const string& each : stringArray(parent, name)) {
+		out.push_back(pool.intern(each));
+	}
+
+	return out;
+}
+
+static bool getBool(const Value& parent, const char* name) {
+	return parent.IsObject() && parent.HasMember(name) && parent[name].IsBool() && parent[name].GetBool();
+}
+
+//Splits an SRD route entry on single spaces, as the filed route comparison always has
+static vector<string> splitRoute(const string& s) {
+	vector<string> out{};
+	istringstream iss(s);
+	string item;
+	while (getline(iss, item, ' ')) {
+		out.push_back(item);
+	}
+	return out;
+}
+
+static vector<RoutePattern> compileRoutes(const vector<string>& routes, StringPool& pool) {
+	vector<RoutePattern> out{};
+
+	for (const string& r : routes) {
+		RoutePattern pattern;
+
+		if (r == WILDCARD_TOKEN) {
+			pattern.matchAll = true;
+		}
+		else {
+			for (string token : splitRoute(r)) {
+				transform(token.begin(), token.end(), token.begin(), [](unsigned char c) { return static_cast<char>(toupper(c)); });
+
+				if (token == WILDCARD_TOKEN) {
+					pattern.tokens.push_back(WILDCARD_ID);
+				}
+				else {
+					pattern.tokens.push_back(pool.intern(token));
+				}
+			}
+		}
+
+		out.push_back(pattern);
+	}
+
+	return out;
+}
+
+//Reads an "HHMM" time string into minutes past midnight
+static bool parseTime(const string& s, int& out) {
+	if (s.size() < 4 || !all_of(s.begin(), s.begin() + 4, [](unsigned char c) { return isdigit(c); })) {
+		return false;
+	}
+
+	out = stoi(s.substr(0, 2)) * 60 + stoi(s.substr(2, 2));
+	return true;
+}
+
+static vector<RestrictionRule> compileRestrictions(const Value& parent, const string& context, vector<string>& diagnostics) {
+	vector<RestrictionRule> out{};
+
+	if (!isArray(parent, "restrictions")) {
+		return out;
+	}
+
+	const Value& restrictions = parent["restrictions"];
+	for (SizeType i = 0; i < restrictions.Size(); i++) {
+		const Value& r = restrictions[i];
+		if (!r.IsObject()) {
+			diagnostics.push_back(context + " - Restriction " + to_string(i) + " Ignored (Not An Object)");
+			continue;
+		}
+
+		RestrictionRule rest;
+		rest.suffix = stringArray(r, "suffix");
+		rest.types = stringArray(r, "types");
+		for (const string& each : rest.types) {
+			rest.typeInitials += each.size() ? each[0] : '\0';
+		}
+
+		if (r.HasMember("start") && r.HasMember("end")) {
+			rest.hasWindow = true;
+			const Value& start = r["start"];
+			const Value& end = r["end"];
+
+			if (start.IsObject() && end.IsObject()) {
+				if (start.HasMember("date") && start["date"].IsInt() && end.HasMember("date") && end["date"].IsInt()) {
+					rest.hasDate = true;
+					rest.startDate = start["date"].GetInt();
+					rest.endDate = end["date"].GetInt();
+				}
+
+				if (start.HasMember("time") && start["time"].IsString() && end.HasMember("time") && end["time"].IsString()) {
+					rest.startTimeText = start["time"].GetString();
+					rest.endTimeText = end["time"].GetString();
+
+					if (parseTime(rest.startTimeText, rest.startTime) && parseTime(rest.endTimeText, rest.endTime)) {
+						rest.hasTime = true;
+					}
+					else {
+						diagnostics.push_back(context + " - Restriction " + to_string(i) + " Time Unreadable (" + rest.startTimeText + "-" + rest.endTimeText + ")");
+					}
+				}
+			}
+		}
+
+		if (rest.hasDate || rest.hasTime) {
+			for (int m = 0; m < WeekWindow::MINUTES; m++) {
+				if (windowOpen(rest, m / 1440, m % 1440)) {
+					rest.window.set(m);
+				}
+			}
+			rest.window.finish();
+		}
+
+		rest.banned = getBool(r, "banned");
+		rest.sidLevel = getBool(r, "sidlevel");
+		rest.alt = stringArray(r, "alt");
+
+		out.push_back(std::move(rest));
+	}
+
+	return out;
+}
+
+static ConstraintRule compileConstraint(const Value& c, StringPool& pool, const string& context, vector<string>& diagnostics) {
+	ConstraintRule con;
+
+	if (!c.IsObject()) {
+		diagnostics.push_back(context + " Not An Object - Treated As Unrestricted");
+		return con;
+	}
+
+	con.dests = stringArray(c, "dests");
+	con.nodests = stringArray(c, "nodests");
+
+	con.pointsIsArray = isArray(c, "points");
+	con.nopointsIsArray = isArray(c, "nopoints");
+	con.points = idArray(c, "points", pool);
+	con.nopoints = idArray(c, "nopoints", pool);
+
+	con.routeIsArray = isArray(c, "route");
+	con.norouteIsArray = isArray(c, "noroute");
+	con.routeText = stringArray(c, "route");
+	con.norouteText = stringArray(c, "noroute");
+	con.route = compileRoutes(con.routeText, pool);
+	con.noroute = compileRoutes(con.norouteText, pool);
+
+	if (c.HasMember("min")) {
+		con.hasMin = true;
+		if (c["min"].IsInt()) {
+			con.minIsInt = true;
+			con.min = c["min"].GetInt();
+		}
+	}
+
+	if (c.HasMember("max")) {
+		con.hasMax = true;
+		if (c["max"].IsInt()) {
+			con.maxIsInt = true;
+			con.max = c["max"].GetInt();
+		}
+	}
+
+	if (c.HasMember("dir") && c["dir"].IsString()) {
+		string direction = c["dir"].GetString();
+		transform(direction.begin(), direction.end(), direction.begin(), [](unsigned char ch) { return static_cast<char>(toupper(ch)); });
+
+		if (direction == EVEN_DIR) {
+			con.dir = LevelDirection::Even;
+		}
+		else if (direction == ODD_DIR) {
+			con.dir = LevelDirection::Odd;
+		}
+		else {
+			con.dir = LevelDirection::Other;
+		}
+	}
+
+	con.restrictions = compileRestrictions(c, context, diagnostics);
+
+	if (isArray(c, "alerts")) {
+		const Value& alerts = c["alerts"];
+		for (SizeType i = 0; i < alerts.Size(); i++) {
+			if (!alerts[i].IsObject()) {
+				continue;
+			}
+
+			AlertRule alert;
+			alert.ban = getBool(alerts[i], "ban");
+			alert.warn = getBool(alerts[i], "warn");
+
+			if (alerts[i].HasMember("srd") && alerts[i]["srd"].IsInt()) {
+				alert.hasSrd = true;
+				alert.srd = alerts[i]["srd"].GetInt();
+			}
+
+			if (alerts[i].HasMember("note") && alerts[i]["note"].IsString()) {
+				alert.hasNote = true;
+				alert.note = alerts[i]["note"].GetString();
+			}
+
+			con.alerts.push_back(alert);
+		}
+	}
+
+	return con;
+}
+
+void RouteTrie::add(const RoutePattern& pattern, size_t constraint) {
+	uint32_t node = 0;
+
+	//A whole-entry wildcard matches any route, including an empty one, so ends at the root
+	if (!pattern.matchAll) {
+		for (StringId token : pattern.tokens) {
+			uint32_t next = token == WILDCARD_ID ? nodes[node].wildcard : NO_NODE;
+			if (token != WILDCARD_ID) {
+				auto it = nodes[node].children.find(token);
+				if (it != nodes[node].children.end()) {
+					next = it->second;
+				}
+			}
+
+			if (next == NO_NODE) {
+				next = static_cast<uint32_t>(nodes.size());
+				nodes.push_back(Node());
+
+				if (token == WILDCARD_ID) {
+					nodes[node].wildcard = next;
+				}
+				else {
+					nodes[node].children[token] = next;
+				}
+			}
+
+			node = next;
+		}
+	}
+
+	nodes[node].ends.push_back(static_cast<uint32_t>(constraint));
+}
+
+ConstraintSet RouteTrie::match(const vector<StringId>& route, size_t count) const {
+	ConstraintSet out(count, false);
+
+	//Nodes reached by the first depth tokens - more than one only where a wildcard edge and a token edge both match
+	vector<uint32_t> active{ 0 };
+	vector<uint32_t> next{};
+
+	for (size_t depth = 0; active.size(); depth++) {
+		next.clear();
+
+		for (uint32_t node : active) {
+			const Node& n = nodes[node];
+
+			for (uint32_t each : n.ends) {
+				out.set(each);
+			}
+
+			if (depth == route.size()) {
+				continue;
+			}
+
+			if (n.wildcard != NO_NODE) {
+				next.push_back(n.wildcard);
+			}
+
+			auto it = n.children.find(route[depth]);
+			if (it != n.children.end()) {
+				next.push_back(it->second);
+			}
+		}
+
+		active.swap(next);
+	}
+
+	return out;
+}
+
+//Adds constraint i to the set stored under key, creating an empty set of count if needed
+template <typename K>
+static void addToIndex(unordered_map<K, ConstraintSet>& index, const K& key, size_t count, size_t i) {
+	auto it = index.find(key);
+	if (it == index.end()) {
+		it = index.insert(make_pair(key, ConstraintSet(count, false))).first;
+	}
+	it->second.set(i);
+}
+
+static SidIndex buildIndex(const vector<ConstraintRule>& constraints) {
+	size_t count = constraints.size();
+
+	SidIndex index;
+	index.anyDest.assign(count, false);
+	index.anyPoint.assign(count, false);
+	index.anyRoute.assign(count, false);
+
+	for (size_t i = 0; i < count; i++) {
+		const ConstraintRule& con = constraints[i];
+
+		if (con.dests.empty()) {
+			index.anyDest.set(i);
+		}
+
+		//An empty entry never matches a destination, so is left out
+		for (const string& each : con.dests) {
+			if (each.size()) {
+				addToIndex(index.dests, each, count, i);
+			}
+		}
+
+		for (const string& each : con.nodests) {
+			if (each.size()) {
+				addToIndex(index.nodests, each, count, i);
+			}
+		}
+
+		if (con.points.empty()) {
+			index.anyPoint.set(i);
+		}
+
+		for (StringId each : con.points) {
+			addToIndex(index.points, each, count, i);
+		}
+
+		for (StringId each : con.nopoints) {
+			addToIndex(index.nopoints, each, count, i);
+		}
+
+		if (con.route.empty()) {
+			index.anyRoute.set(i);
+		}
+
+		for (const RoutePattern& pattern : con.route) {
+			index.route.add(pattern, i);
+		}
+
+		for (const RoutePattern& pattern : con.noroute) {
+			index.noroute.add(pattern, i);
+		}
+	}
+
+	return index;
+}
+
+static string sidName(const SidRule& sid, size_t i) {
+	return "SID " + (sid.hasPoint ? (sid.point.size() ? sid.point : "(Non-SID)") : to_string(i));
+}
+
+//Maps every point and alias of a SID with constraints to the SID - a name used more than once goes to the last SID using it
+static void buildSidLookup(AirportRules& out, vector<string>& diagnostics) {
+	for (size_t i = 0; i < out.sids.size(); i++) {
+		const SidRule& sid = out.sids[i];
+		if (!sid.hasConstraints) {
+			continue;
+		}
+
+		vector<string> names{};
+		if (sid.hasPoint) {
+			names.push_back(sid.point);
+		}
+
+		for (const string& alias : sid.aliases) {
+			if (find(names.begin(), names.end(), alias) != names.end()) {
+				diagnostics.push_back(sidName(sid, i) + " - Alias " + alias + " Listed More Than Once");
+				continue;
+			}
+			names.push_back(alias);
+		}
+
+		for (const string& name : names) {
+			auto it = out.sidLookup.find(name);
+			if (it != out.sidLookup.end()) {
+				diagnostics.push_back(sidName(sid, i) + " - " + (name.size() ? name : "(Non-SID)") + " Also Used By " + sidName(out.sids[it->second], it->second) + " (Ignored There)");
+				it->second = i;
+			}
+			else {
+				out.sidLookup.insert(make_pair(name, i));
+			}
+		}
+	}
+}
+
+bool compileAirport(const Value& airport, AirportRules& out, vector<string>& diagnostics) {
+	if (!airport.IsObject() || !airport.HasMember("icao") || !airport["icao"].IsString()) {
+		return false;
+	}
+
+	out.icao = airport["icao"].GetString();
+
+	if (!isArray(airport, "sids")) {
+		return true;
+	}
+
+	const Value& sids = airport["sids"];
+	for (SizeType i = 0; i < sids.Size(); i++) {
+		const Value& s = sids[i];
+		SidRule sid;
+
+		if (!s.IsObject()) {
+			diagnostics.push_back("SID " + to_string(i) + " Ignored (Not An Object)");
+			out.sids.push_back(sid);
+			continue;
+		}
+
+		if (s.HasMember("point") && s["point"].IsString()) {
+			sid.hasPoint = true;
+			sid.point = s["point"].GetString();
+		}
+
+		string context = sidName(sid, i);
+
+		sid.aliases = stringArray(s, "aliases");
+		sid.restrictions = compileRestrictions(s, context, diagnostics);
+
+		sid.hasConstraints = isArray(s, "constraints");
+		if (sid.hasConstraints) {
+			const Value& constraints = s["constraints"];
+			for (SizeType j = 0; j < constraints.Size(); j++) {
+				sid.constraints.push_back(compileConstraint(constraints[j], out.pool, context + " Constraint " + to_string(j), diagnostics));
+			}
+		}
+
+		StatTimer timer(Metric::IndexBuild);
+		sid.index = buildIndex(sid.constraints);
+		timer.stop();
+
+		out.sids.push_back(sid);
+	}
+
+	buildSidLookup(out, diagnostics);
+
+	return true;
+}
+
+bool windowOpen(const RestrictionRule& rest, int day, int minute) {
+	if (!rest.hasDate && !rest.hasTime) {
+		return true;
+	}
+
+	int start = rest.hasTime ? rest.startTime : 0;
+	int end = rest.hasTime ? rest.endTime : 0;
+
+	if (!rest.hasDate) {
+		//Daily window, which may span midnight
+		if (start >= end) {
+			return minute >= start || minute <= end;
+		}
+
+		return minute >= start && minute <= end;
+	}
+	else if (rest.startDate == rest.endDate) {
+		return !rest.hasTime || (minute >= start && minute <= end);
+	}
+	else if (rest.startDate < rest.endDate) {
+		if (day > rest.startDate && day < rest.endDate) {
+			return true;
+		}
+	}
+	else if (day < rest.startDate || day > rest.endDate) {
+		return true;
+	}
+
+	if (day == rest.startDate) {
+		return !rest.hasTime || minute >= start;
+	}
+	else if (day == rest.endDate) {
+		return !rest.hasTime || minute < end;
+	}
+
+	return false;
+}
+
+static const size_t WINDOW_WORDS = (WeekWindow::MINUTES + 63) / 64;
+
+void WeekWindow::set(int minuteOfWeek) {
+	if (words.empty()) {
+		words.assign(WINDOW_WORDS, 0);
+	}
+
+	words[minuteOfWeek / 64] |= 1ULL << (minuteOfWeek % 64);
+}
+
+void WeekWindow::finish() {
+	if (words.empty()) {
+		//Nothing was set - never open
+		words.assign(WINDOW_WORDS, 0);
+		return;
+	}
+
+	for (int m = 0; m < MINUTES; m++) {
+		if (!open(m)) {
+			return;
+		}
+	}
+
+	words.clear();
+}
+
+int WeekWindow::nextTransition(int minuteOfWeek) const {
+	if (words.empty()) {
+		return -1;
+	}
+
+	bool state = open(minuteOfWeek);
+
+	//Scan forward a word at a time for the first minute in the other state, wrapping round the week once
+	for (int offset = 1; offset < MINUTES;) {
+		int m = (minuteOfWeek + offset) % MINUTES;
+		int bit = m % 64;
+		int span = 64 - bit;
+
+		//Last word is only partly used
+		if (m / 64 == static_cast<int>(WINDOW_WORDS) - 1) {
+			span = MINUTES - m;
+		}
+		if (span > MINUTES - offset) {
+			span = MINUTES - offset;
+		}
+
+		uint64_t word = words[m / 64] >> bit;
+		if (state) {
+			word = ~word;
+		}
+		if (span < 64) {
+			word &= (1ULL << span) - 1;
+		}
+
+		if (word) {
+			return offset + lowestBit(word);
+		}
+
+		offset += span;
+	}
+
+	return -1;
+}
@@ -0,0 +1,209 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "rapidjson/document.h"
+#include "constraintSet.hpp"
+
+/***********************************************************
+* Compiled form of the SID data set.
+*
+* The API/Sid.json document is walked once at load time and
+* turned into the plain structs below, so that the checks run
+* on every tag refresh never touch the rapidjson DOM. Strings
+* which are compared for equality (exit points, route tokens)
+* are interned per airport and compared as integers.
+*
+* Each SID also gets inverted indexes from destination
+* prefixes, exit points and leading route tokens to the set of
+* its constraints they satisfy, so the destination, exit point
+* and route rounds are a handful of hash lookups and bitwise
+* ORs rather than a scan of every constraint's arrays. Route
+* patterns are compiled into a token trie, so the filed route
+* is matched against every constraint in one walk.
+***********************************************************/
+
+typedef uint32_t StringId;
+
+const StringId NO_STRING_ID = 0xFFFFFFFF; //Not present in the pool - never matches
+const StringId WILDCARD_ID = 0xFFFFFFFE; //Route wildcard ("*") - matches any token
+
+class StringPool {
+public:
+	StringId intern(const std::string& s);
+
+	StringId find(const std::string& s) const;
+
+	const std::string& str(StringId id) const;
+
+	size_t size() const { return strings.size(); }
+
+private:
+	std::vector<std::string> strings;
+	std::unordered_map<std::string, StringId> ids;
+};
+
+enum class LevelDirection {
+	None, //No "dir" member - any level
+	Even,
+	Odd,
+	Other //"dir" member present but neither EVEN nor ODD - any level
+};
+
+//Day/time window as one bit per minute of the week (0 = Monday 0000), so "is it open now" is a single bit test
+class WeekWindow {
+public:
+	static const int MINUTES = 7 * 1440;
+
+	//Default is always open
+	bool alwaysOpen() const { return words.empty(); }
+
+	bool open(int minuteOfWeek) const {
+		return words.empty() || (words[minuteOfWeek / 64] >> (minuteOfWeek % 64) & 1) != 0;
+	}
+
+	//Minutes from minuteOfWeek until the window next opens or closes, -1 if it never does
+	int nextTransition(int minuteOfWeek) const;
+
+	void set(int minuteOfWeek);
+
+	//Drops the bitmap if every minute is open
+	void finish();
+
+private:
+	friend struct RuleImageCodec; //Copies the bitmap to and from a rule image as is
+
+	std::vector<uint64_t> words;
+};
+
+struct RestrictionRule {
+	std::vector<std::string> suffix;
+	std::vector<std::string> types;
+	std::string typeInitials; //First character of each entry in types, matched against engine/aircraft type
+
+	bool hasWindow = false; //"start" and "end" members present
+	bool hasDate = false;
+	bool hasTime = false;
+	int startDate = 0;
+	int endDate = 0;
+	int startTime = 0; //Minutes past midnight
+	int endTime = 0;
+	std::string startTimeText; //As supplied ("HHMM"), for output
+	std::string endTimeText;
+	WeekWindow window; //Compiled from the above
+
+	bool banned = false;
+	bool sidLevel = false;
+	std::vector<std::string> alt;
+};
+
+struct AlertRule {
+	bool ban = false;
+	bool warn = false;
+	bool hasSrd = false;
+	int srd = 0;
+	bool hasNote = false;
+	std::string note;
+};
+
+struct RoutePattern {
+	bool matchAll = false; //Whole entry is the wildcard
+	std::vector<StringId> tokens;
+};
+
+struct ConstraintRule {
+	std::vector<std::string> dests;
+	std::vector<std::string> nodests;
+
+	std::vector<StringId> points;
+	std::vector<StringId> nopoints;
+	bool pointsIsArray = false;
+	bool nopointsIsArray = false;
+
+	std::vector<RoutePattern> route;
+	std::vector<RoutePattern> noroute;
+	std::vector<std::string> routeText;
+	std::vector<std::string> norouteText;
+	bool routeIsArray = false;
+	bool norouteIsArray = false;
+
+	bool hasMin = false; //Member present
+	bool minIsInt = false;
+	int min = 0;
+	bool hasMax = false;
+	bool maxIsInt = false;
+	int max = 0;
+
+	LevelDirection dir = LevelDirection::None;
+
+	std::vector<RestrictionRule> restrictions;
+	std::vector<AlertRule> alerts;
+};
+
+//Token trie of the route patterns of one SID's constraints, with a separate edge for the wildcard
+class RouteTrie {
+public:
+	void add(const RoutePattern& pattern, size_t constraint);
+
+	//Constraints with a pattern matching the start of route, as a set of count
+	ConstraintSet match(const std::vector<StringId>& route, size_t count) const;
+
+private:
+	friend struct RuleImageCodec; //Copies the nodes to and from a rule image as is
+
+	static const uint32_t NO_NODE = 0xFFFFFFFF;
+
+	struct Node {
+		std::unordered_map<StringId, uint32_t> children;
+		uint32_t wildcard = NO_NODE;
+		std::vector<uint32_t> ends; //Constraints with a pattern ending here
+	};
+
+	std::vector<Node> nodes{ Node() };
+};
+
+//Constraints of one SID keyed by the flight plan values that select or exclude them
+struct SidIndex {
+	ConstraintSet anyDest; //No "dests" - passes whatever the destination
+	std::unordered_map<std::string, ConstraintSet> dests; //"dests" entry (a destination prefix) -> constraints listing it
+	std::unordered_map<std::string, ConstraintSet> nodests;
+
+	ConstraintSet anyPoint; //No "points"
+	std::unordered_map<StringId, ConstraintSet> points;
+	std::unordered_map<StringId, ConstraintSet> nopoints;
+
+	ConstraintSet anyRoute; //No "route"
+	RouteTrie route;
+	RouteTrie noroute;
+};
+
+struct SidRule {
+	bool hasPoint = false;
+	std::string point;
+	std::vector<std::string> aliases;
+	bool hasConstraints = false;
+	std::vector<RestrictionRule> restrictions;
+	std::vector<ConstraintRule> constraints;
+	SidIndex index;
+};
+
+struct AirportRules {
+	std::string icao;
+	std::vector<SidRule> sids;
+	std::unordered_map<std::string, size_t> sidLookup; //SID point or alias -> index in sids, for SIDs with constraints
+	StringPool pool;
+
+	//Index of the SID with first_wp as its point or an alias, or std::string::npos
+	size_t findSid(const std::string& first_wp) const {
+		auto it = sidLookup.find(first_wp);
+		return it != sidLookup.end() ? it->second : std::string::npos;
+	}
+};
+
+//Compiles a single airport element of the data set. Problems that do not prevent use of the data are reported in diagnostics.
+bool compileAirport(const rapidjson::Value& airport, AirportRules& out, std::vector<std::string>& diagnostics);
+
+//Evaluates a restriction's day/time window at the given day of week (0 = Monday) and minute of day
+//Only used to compile WeekWindow - checks should use rest.window
+bool windowOpen(const RestrictionRule& rest, int day, int minute);
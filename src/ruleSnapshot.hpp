@@ -0,0 +1,50 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include "ruleModel.hpp"
+
+/***********************************************************
+* Published SID rule data.
+*
+* The web call worker compiles a complete RuleSnapshot off the
+* EuroScope thread and publishes it with a single atomic
+* pointer swap. A snapshot is never modified once published,
+* so readers just take a reference and use it for as long as
+* they need, and never see a half-built map. The shared_ptr
+* atomics are not lock-free (MSVC guards them with a spin
+* lock), but that lock is only held to copy the pointer, never
+* while data is compiled. The previous snapshot is freed when
+* its last reader lets go. Airports whose data did not change are shared
+* between consecutive snapshots rather than copied.
+***********************************************************/
+
+struct RuleSnapshot {
+	std::map<std::string, std::shared_ptr<const AirportRules>> airports;
+	unsigned int generation = 0; //Distinguishes cached check results computed against older data
+};
+
+typedef std::shared_ptr<const RuleSnapshot> RuleSnapshotPtr;
+
+class RuleStore {
+public:
+	RuleStore() : current(std::make_shared<RuleSnapshot>()) {}
+
+	//Current snapshot - hold on to the returned pointer for the duration of a check
+	RuleSnapshotPtr load() const {
+		return std::atomic_load(&current);
+	}
+
+	//Unconditionally replaces the current snapshot
+	void publish(RuleSnapshotPtr next) {
+		std::atomic_store(&current, std::move(next));
+	}
+
+	//Replaces the current snapshot only if it is still expected, else returns false
+	bool replace(RuleSnapshotPtr expected, RuleSnapshotPtr next) {
+		return std::atomic_compare_exchange_strong(&current, &expected, std::move(next));
+	}
+
+private:
+	RuleSnapshotPtr current;
+};
@@ -0,0 +1,1609 @@
+#include "sidChecker.hpp"
+#include <climits>
+#include <boost/algorithm/string.hpp>
+
+using namespace std;
+
+//ORs the set stored under key, if any, into out
+template <typename K>
+static void addIndexed(ConstraintSet& out, const unordered_map<K, ConstraintSet>& index, const K& key) {
+	auto it = index.find(key);
+	if (it != index.end()) {
+		out |= it->second;
+	}
+}
+
+void SidChecker::checkDestination(const SidIndex& index, string destination, ConstraintSet& candidates) {
+	//Every prefix of the destination is a possible "dests" entry
+	ConstraintSet allowed = index.anyDest;
+	ConstraintSet banned(candidates.size(), false);
+	for (size_t len = 1; len <= destination.size(); len++) {
+		string prefix = destination.substr(0, len);
+		addIndexed(allowed, index.dests, prefix);
+		addIndexed(banned, index.nodests, prefix);
+	}
+
+	candidates &= allowed;
+	candidates.subtract(banned);
+}
+
+void SidChecker::checkExitPoint(const SidIndex& index, const vector<StringId>& points, ConstraintSet& candidates) {
+	ConstraintSet allowed = index.anyPoint;
+	ConstraintSet banned(candidates.size(), false);
+	for (StringId each : points) {
+		addIndexed(allowed, index.points, each);
+		addIndexed(banned, index.nopoints, each);
+	}
+
+	candidates &= allowed;
+	candidates.subtract(banned);
+}
+
+void SidChecker::checkRoute(const SidIndex& index, const vector<StringId>& route, ConstraintSet& candidates) {
+	ConstraintSet allowed = index.route.match(route, candidates.size());
+	allowed |= index.anyRoute;
+
+	candidates &= allowed;
+	candidates.subtract(index.noroute.match(route, candidates.size()));
+}
+
+vector<bool> SidChecker::checkRestriction(const FlightPlanView& flightPlan, string sid_suffix, const vector<RestrictionRule>& restrictions, bool *sidfails, bool *constfails, int minuteOfWeek, int* windowChange) {
+	bufLog(flightPlan.callsign + " Restrictions Check: " + " - SID Suffix: " + sid_suffix + ", SID Fails: " + BoolToString(*sidfails) + ", Const Fails" + BoolToString(*constfails));
+	vector<bool> res{ 0, 0 }; //0 = Constraint-Level Pass, 1 = SID-Level Pass
+	bool constExists = false;
+	if (restrictions.size()) {
+		char engine = flightPlan.engineType;
+		char aircraft = flightPlan.aircraftType;
+
+		for (const RestrictionRule& rest : restrictions) {
+			bool temp = true;
+			bool *fails;
+
+			if (rest.sidLevel) {
+				fails = sidfails;
+			}
+			else {
+				fails = constfails;
+				constExists = true;
+			}
+
+			if (rest.suffix.size()) {
+				if (arrayContainsEnding(rest.suffix, sid_suffix)) {
+					fails[0] = false;
+				}
+				else {
+					temp = false;
+				}
+			}
+			else {
+				fails[0] = false;
+			}
+
+			if (rest.types.size()) {
+				fails[1] = true;
+				if (rest.typeInitials.find(engine) == string::npos && rest.typeInitials.find(aircraft) == string::npos) {
+					temp = false;
+				}
+			}
+
+			if (rest.hasWindow && (rest.hasDate || rest.hasTime)) {
+				fails[2] = true;
+
+				if (!rest.window.open(minuteOfWeek)) {
+					temp = false;
+				}
+
+				//Earliest time this result could change
+				int change = rest.window.nextTransition(minuteOfWeek);
+				if (change >= 0 && (*windowChange < 0 || change < *windowChange)) {
+					*windowChange = change;
+				}
+			}
+
+			if (rest.banned) {
+				fails[3] = true;
+				temp = false;
+			}
+
+			if (temp) {
+				res[rest.sidLevel] = true;
+			}
+		}
+
+		bufLog(flightPlan.callsign + " Restrictions Check: " + " - Complete");
+	}
+
+	if (!constExists) {
+		res[0] = true;
+	}
+		
+	return res;
+}
+
+void SidChecker::checkRestrictions(const FlightPlanView& flightPlan, const vector<ConstraintRule>& conditions, string sid_suffix, bool *sidfails, bool *constfails, bool *sidwide, int minuteOfWeek, int* windowChange, ConstraintSet& candidates) {
+	candidates.filter([&](size_t i) {
+		vector<bool> temp = checkRestriction(flightPlan, sid_suffix, conditions[i].restrictions, sidfails, constfails, minuteOfWeek, windowChange);
+
+		if (temp[1]) {
+			*sidwide = true;
+		}
+
+		return static_cast<bool>(temp[0]);
+	});
+}
+
+void SidChecker::checkMinMax(const vector<ConstraintRule>& conditions, int RFL, ConstraintSet& candidates) {
+	candidates.filter([&](size_t i) {
+		//Min Level
+		if (conditions[i].minIsInt && conditions[i].min > 0 && (RFL / 100) < conditions[i].min) {
+			return false;
+		}
+
+		//Max Level
+		if (conditions[i].maxIsInt && conditions[i].max > 0 && (RFL / 100) > conditions[i].max) {
+			return false;
+		}
+
+		return true;
+	});
+}
+
+void SidChecker::checkDirection(const vector<ConstraintRule>& conditions, int RFL, ConstraintSet& candidates) {
+	candidates.filter([&](size_t i) {
+		LevelDirection direction = conditions[i].dir;
+
+		if (direction == LevelDirection::Even) {
+			//Non-RVSM (Above FL410)
+			if (RFL > RVSM_UPPER) {
+				return ((RFL - RVSM_UPPER) / 1000) % 4 == 2;
+			}
+			//RVSM (FL290-410) or Below FL290
+			return (RFL / 1000) % 2 == 0;
+		}
+		else if (direction == LevelDirection::Odd) {
+			//Non-RVSM (Above FL410)
+			if (RFL > RVSM_UPPER) {
+				return ((RFL - RVSM_UPPER) / 1000) % 4 == 0;
+			}
+			//RVSM (FL290-410) or Below FL290
+			return (RFL / 1000) % 2 == 1;
+		}
+
+		//Assume any level valid if no "EVEN" or "ODD" declaration
+		return true;
+	});
+}
+
+void SidChecker::checkAlerts(const vector<ConstraintRule>& conditions, bool *warn, ConstraintSet& candidates) {
+	candidates.filter([&](size_t i) {
+		bool res = true;
+
+		for (const AlertRule& alert : conditions[i].alerts) {
+			if (alert.ban) {
+				res = false;
+			}
+
+			if (alert.warn) {
+				*warn = true;
+			}
+		}
+
+		return res;
+	});
+}
+
+//Checks flight plan
+CheckResult SidChecker::validateSid(const FlightPlanView& flightPlan, const RuleSnapshot& rules, int minuteOfWeek) {
+	StatTimer timer(Metric::ValidateSid);
+
+	string callsign = flightPlan.callsign;
+	CheckResult result;
+
+	string origin = flightPlan.origin; boost::to_upper(origin);
+	string destination = flightPlan.destination; boost::to_upper(destination);
+
+	// Airport defined
+	map<string, std::shared_ptr<const AirportRules>>::const_iterator apt = rules.airports.find(origin);
+	if (apt == rules.airports.end()) {
+		result.sidStatus = SidStatus::AirportNotFound;
+		return result;
+	}
+
+	const AirportRules& airport = *apt->second;
+
+	int RFL = flightPlan.rfl;
+
+	string rawroute = flightPlan.route;
+	bufLog(callsign + string(" Validate: Route - ") + rawroute);
+	boost::trim(rawroute);
+
+	vector<string> route = split(rawroute, ' ');
+
+	vector<string>::iterator itr = remove_if(route.begin(), route.end(), mem_fun_ref(&string::empty));
+	route.erase(itr, route.end());
+
+	for (size_t i = 0; i < route.size(); i++) {
+		boost::to_upper(route[i]);
+	}
+
+	vector<StringId> points{};
+	for (const string& each : flightPlan.points) {
+		points.push_back(airport.pool.find(each));
+	}
+
+
+	string sid = flightPlan.sid; boost::to_upper(sid);
+	string first_wp = "";
+	string sid_suffix = "";
+
+	//Route with SID
+	if (sid.length()) {
+		// Remove any # characters from SID name
+		boost::erase_all(sid, OUTDATED_SID);
+
+		if (origin == "EGLL" && sid == "CHK") {
+			bufLog(callsign + string(" Validate: First Waypoint - EGLL CPT Easterly Procedure In Use"));
+			first_wp = "CPT";
+			sid_suffix = "CHK";
+		}
+		else {
+			first_wp = sid.substr(0, sid.find_first_of("0123456789"));
+			sid_suffix = sid.back();
+			if (0 != first_wp.length())
+				boost::to_upper(first_wp);
+		}
+	}
+
+	bool success = true;
+	vector<string> new_route{};
+	SyntaxError outchk = SyntaxError::None;
+	bool repeat = false;
+
+	for (size_t i = 0; i < 5; i++) {
+		if (success) {
+			if (route.size() > 0) {
+				switch (i) {
+				case 0:
+					if (classifyRouteToken(route.front()) & TOKEN_SPDLVL) {
+						route.erase(route.begin());
+					}
+					break;
+				case 1:
+					do {
+						repeat = true;
+						unsigned token = route.empty() ? TOKEN_WAYPOINT : classifyRouteToken(route.front());
+
+						if (route.empty()) {
+							repeat = false;
+						}
+						else if (token & TOKEN_SIDSTAR_RWY) {
+							route.erase(route.begin());
+						}
+						else if (!strcmp(route.front().c_str(), "SID")) {
+							route.erase(route.begin());
+						}
+						else if (token & TOKEN_ICAO_RWY) {
+							if (!strcmp(route.front().substr(0, 4).c_str(), origin.c_str())) {
+								route.erase(route.begin());
+							}
+							else {
+								outchk = SyntaxError::DifferentOrigin;
+								success = false;
+								repeat = false;
+							}
+						}
+						else {
+							repeat = false;
+						}
+					} while (repeat);
+					break;
+				case 2:
+					do {
+						repeat = true;
+						unsigned token = route.empty() ? TOKEN_WAYPOINT : classifyRouteToken(route.back());
+
+						if (route.empty()) {
+							repeat = false;
+						}
+						else if (token & TOKEN_SIDSTAR_RWY) {
+							route.pop_back();
+						}
+						else if (!strcmp(route.back().c_str(), "STAR")) {
+							route.pop_back();
+						}
+						else if (token & TOKEN_ICAO_RWY) {
+							if (!strcmp(route.back().substr(0, 4).c_str(), destination.c_str())) {
+								route.pop_back();
+							}
+							else {
+								outchk = SyntaxError::DifferentDestination;
+								success = false;
+								repeat = false;
+							}
+						}
+						else {
+							repeat = false;
+						}
+					} while (repeat);
+					break;
+				case 3:
+					for (const string& each : route) {
+						unsigned token = classifyRouteToken(each);
+
+						if (token & TOKEN_DCT_SPDLVL) {
+							if (outchk == SyntaxError::None) {
+								outchk = SyntaxError::DirectSpeedLevel;
+							}
+							success = false;
+						}
+						else if (strcmp(each.c_str(), "DCT")) {
+							if (token & TOKEN_AIRWAY) {
+								new_route.push_back(each);
+							}
+							else {
+								size_t slash = each.find('/');
+
+								if (slash == string::npos) {
+									new_route.push_back(each);
+								}
+								else {
+									if (token & TOKEN_SPDLVL_CHANGE) {
+										new_route.push_back(each.substr(0, slash));
+									}
+									else {
+										outchk = SyntaxError::InvalidSpeedLevelChange;
+										success = false;
+									}
+								}
+							}
+						}
+					}
+
+					route = new_route;
+					break;
+				case 4:
+					if (sid.length()) {
+						if (strcmp(route.front().c_str(), first_wp.c_str())) {
+							outchk = SyntaxError::NotFromFirstWaypoint;
+							success = false;
+						}
+						else {
+							route.erase(route.begin());
+						}
+					}
+
+					break;
+				}
+			}
+			else {
+				outchk = SyntaxError::NoRoute;
+				success = false;
+			}
+		}
+	}
+
+	if (!success) {
+		result.syntax = outchk;
+		return result;
+	}
+
+	vector<StringId> route_ids{};
+	for (string each : route) {
+		route_ids.push_back(airport.pool.find(each));
+	}
+
+	// Any SIDs defined
+	if (!airport.sids.size()) {
+		result.sidStatus = SidStatus::NoSids;
+		return result;
+	}
+
+	//Find routes for selected SID
+	size_t pos = airport.findSid(first_wp);
+
+	// Needed SID defined
+	if (pos == string::npos) {
+		result.sid = sid;
+		result.sidStatus = first_wp == "" ? SidStatus::SidRequired : SidStatus::SidNotFound;
+		return result;
+	} 
+	else {
+		const SidRule& sid_ele = airport.sids[pos];
+		const vector<ConstraintRule>& conditions = sid_ele.constraints;
+
+		int round = 0;
+		bool* sidFails = result.sidFails;
+		bool* restFails = result.restFails; // 0 = Suffix, 1 = Aircraft/Engines, 2 = Date/Time Restrictions
+		bool warn = false;
+
+		//SID-Level Restrictions Array
+		sidFails[0] = true;
+		vector<bool> temp = checkRestriction(flightPlan, sid_suffix, sid_ele.restrictions, sidFails, sidFails, minuteOfWeek, &result.windowChange);
+		bool sidwide = false;
+		if (temp[0] || temp[1]) {
+			sidwide = true;
+		}
+
+		//Every constraint starts as a candidate
+		ConstraintSet validity(conditions.size());
+		ConstraintSet new_validity;
+			
+		//Run Checks on Constraints Array
+		while (round < 7) {
+			new_validity = validity;
+			StatTimer roundTimer(roundMetric(round));
+
+			switch (round) {
+			case 0:
+			{
+				//Destinations
+				checkDestination(sid_ele.index, destination, new_validity);
+				break;
+			}
+			case 1:
+			{
+				//Exit Points
+				checkExitPoint(sid_ele.index, points, new_validity);
+				break;
+			}
+			case 2:
+			{
+				//Route
+				checkRoute(sid_ele.index, route_ids, new_validity);
+				break;
+			}
+			case 3:
+			{
+				//Restrictions Array
+				checkRestrictions(flightPlan, conditions, sid_suffix, sidFails, restFails, &sidwide, minuteOfWeek, &result.windowChange, new_validity);
+				break;
+			}
+			case 4:
+			{
+				//Min & Max Levels
+				checkMinMax(conditions, RFL, new_validity);
+				break;
+			}
+			case 5:
+			{
+				//Even/Odd Levels
+				checkDirection(conditions, RFL, new_validity);
+				break;
+			}
+			case 6:
+			{
+				//Alerts (Warn/Ban)
+				checkAlerts(conditions, &warn, new_validity);
+				break;
+			}
+			}
+
+			roundTimer.stop();
+
+			//Stop at the first round which rules out every remaining constraint, keeping those that reached it
+			if (new_validity.none()) {
+				bufLog(callsign + string(" Validate: Checks - Failed On Round ") + to_string(round));
+				break;
+			}
+			else {
+				std::swap(validity, new_validity);
+				round++;
+			}
+		}
+
+		result.sidStatus = SidStatus::Found;
+		result.sid = sid;
+		result.sidIndex = pos;
+		result.round = round;
+		result.sidwide = sidwide;
+
+		result.successes = validity.indexes();
+
+		//Every stage before the one which stopped the checks passed
+		StageStatus* stages = result.stages;
+		if (sidwide) {
+			const CheckStage order[7] = { STAGE_DESTINATION, STAGE_EXIT_POINT, STAGE_ROUTE, STAGE_RESTRICTIONS, STAGE_LEVEL, STAGE_DIRECTION, STAGE_BANS };
+
+			for (int i = 0; i < 7; i++) {
+				stages[order[i]] = i < round ? StageStatus::Passed : (i == round ? StageStatus::Failed : StageStatus::NotChecked);
+			}
+
+			if (round >= 3) {
+				stages[STAGE_SUFFIX] = StageStatus::Passed;
+			}
+
+			if (round == 3 && restFails[0]) {
+				stages[STAGE_SUFFIX] = StageStatus::Failed;
+				stages[STAGE_RESTRICTIONS] = StageStatus::NotChecked;
+			}
+
+			if (round >= 6) {
+				stages[STAGE_WARNINGS] = warn ? StageStatus::Warning : StageStatus::Passed;
+			}
+
+			result.passed = round == 7;
+		}
+		else if (sidFails[0]) {
+			stages[STAGE_SUFFIX] = StageStatus::Failed;
+		}
+		else {
+			stages[STAGE_SUFFIX] = StageStatus::Passed;
+			stages[STAGE_RESTRICTIONS] = StageStatus::Failed;
+		}
+
+		return result;
+	}
+}
+
+//Builds the explanatory text for a check result. out[0] = Normal Output, out[1] = Debug Output
+vector<vector<string>> SidChecker::explainCheck(const FlightPlanView& flightPlan, const CheckResult& result, const RuleSnapshot& rules) {
+	StatTimer timer(Metric::ExplainCheck);
+
+	string callsign = flightPlan.callsign;
+	vector<vector<string>> returnOut = { vector<string>(), vector<string>() }; // 0 = Callsign, 1 = SID, 2 = Destination, 3 = Exit Point, 4 = Route, 5 = Min/Max Flight Level, 6 = Even/Odd, 7 = Suffix, 8 = Restrictions, 9 = Warnings, 10 = Bans, 11 = Syntax, 12 = Passed/Failed
+
+	returnOut[0].push_back(callsign);
+	returnOut[1].push_back(callsign);
+	for (int i = 1; i < 13; i++) {
+		returnOut[0].push_back("-");
+		returnOut[1].push_back("-");
+	}
+
+	returnOut[0].back() = returnOut[1].back() = "Failed";
+
+	string origin = flightPlan.origin; boost::to_upper(origin);
+	string destination = flightPlan.destination; boost::to_upper(destination);
+
+	if (result.syntax != SyntaxError::None) {
+		returnOut[0][returnOut[0].size() - 2] = returnOut[1][returnOut[1].size() - 2] = "Invalid Syntax - " + string(syntaxErrorText(result.syntax)) + ".";
+		return returnOut;
+	}
+
+	map<string, std::shared_ptr<const AirportRules>>::const_iterator apt = rules.airports.find(origin);
+
+	switch (result.sidStatus) {
+	case SidStatus::AirportNotFound:
+		returnOut[0][1] = "Airport Not Found";
+		returnOut[1][1] = origin + " not in database.";
+		return returnOut;
+	case SidStatus::NoSids:
+		returnOut[0][1] = "No SIDs or Non-SID Routes Defined";
+		returnOut[1][1] = origin + " exists in database but has no SIDs (or non-SID routes) defined.";
+		return returnOut;
+	case SidStatus::SidRequired:
+		returnOut[0][1] = "SID Required";
+		returnOut[1][1] = "Non-SID departure routes not in database.";
+		return returnOut;
+	case SidStatus::SidNotFound:
+		returnOut[0][1] = "SID Not Found";
+		returnOut[1][1] = result.sid + " departure not in database.";
+		return returnOut;
+	default:
+		//Data replaced since the check was run
+		if (apt == rules.airports.end() || result.sidIndex >= apt->second->sids.size()) {
+			returnOut[0][1] = "Airport Not Found";
+			returnOut[1][1] = origin + " not in database.";
+			return returnOut;
+		}
+		break;
+	}
+
+	const AirportRules& airport = *apt->second;
+	const SidRule& sid_ele = airport.sids[result.sidIndex];
+	const vector<ConstraintRule>& conditions = sid_ele.constraints;
+	const vector<size_t>& successes = result.successes;
+	int round = result.round;
+	bool warn = result.stages[STAGE_WARNINGS] == StageStatus::Warning;
+	int RFL = flightPlan.rfl;
+
+	vector<StringId> points{};
+	for (const string& each : flightPlan.points) {
+		points.push_back(airport.pool.find(each));
+	}
+
+	if (result.sid.length()) {
+		returnOut[1][1] = returnOut[0][1] = "SID - " + result.sid + ".";
+	}
+	else {
+		returnOut[1][1] = returnOut[0][1] = "Non-SID Route.";
+	}
+
+	if (result.sidwide) {
+		//Generate Output
+		switch (round) {
+		case 7:
+		{
+			returnOut[1].back() = returnOut[0].back() = "Passed";
+			returnOut[1][10] = "No Route Ban.";
+		}
+		case 6:
+		{
+			if (warn) {
+				returnOut[1][9] = returnOut[0][9] = WarningsOutput(flightPlan, airport, conditions, successes, points, destination, RFL);
+			}
+			else {
+				returnOut[1][9] = "No Warnings.";
+			}
+        
+			if (round == 6) {
+				returnOut[1][10] = returnOut[0][10] = BansOutput(flightPlan, airport, conditions, successes, points, destination, RFL);
+			}
+
+			returnOut[0][6] = "Passed Odd-Even Rule.";
+			returnOut[1][6] = "Passed " + DirectionOutput(flightPlan, conditions, successes);
+		}
+		case 5:
+		{
+			if (round == 5) {
+				returnOut[1][6] = returnOut[0][6] = "Failed " + DirectionOutput(flightPlan, conditions, successes);
+			}
+
+			returnOut[0][5] = "Passed Min/Max Level.";
+			returnOut[1][5] = "Passed " + MinMaxOutput(flightPlan, conditions, successes);
+		}
+		case 4:
+		{
+			if (round == 4) {
+				returnOut[1][5] = returnOut[0][5] = "Failed " + MinMaxOutput(flightPlan, conditions, successes) + " Alternative " + RouteOutput(flightPlan, airport, conditions, successes, points, destination, RFL, true);
+			}
+
+			returnOut[0][8] = "Passed SID Restrictions.";
+			returnOut[1][8] = "Passed " + RestrictionsOutput(flightPlan, sid_ele, true, true, true, successes);
+		}
+		case 3:
+		{
+
+			returnOut[0][7] = "Valid Suffix.";
+			returnOut[1][7] = "Valid " + SuffixOutput(flightPlan, sid_ele, successes);
+
+			if (round == 3) {
+				if (result.restFails[0]) {
+					returnOut[1][7] = returnOut[0][7] = "Invalid " + SuffixOutput(flightPlan, sid_ele, successes);
+				}
+				else {
+					//NOTE: In the following it used to be restFails[1], [2], and [4]. However, [4] does not exist. This is assumed to be a typo and has been changed to [3].
+					returnOut[1][8] = returnOut[0][8] = "Failed " + RestrictionsOutput(flightPlan, sid_ele, result.restFails[1], result.restFails[2], result.restFails[3], successes) + " " + AlternativesOutput(flightPlan, sid_ele, successes);
+				}
+			}
+
+			returnOut[0][4] = "Passed Route.";
+			returnOut[1][4] = "Passed Route. " + RouteOutput(flightPlan, airport, conditions, successes, points, destination, RFL);
+		}
+		case 2:
+		{
+			if (round == 2) {
+				returnOut[1][4] = returnOut[0][4] = "Failed Route. " + RouteOutput(flightPlan, airport, conditions, successes, points, destination, RFL);
+			}
+
+			returnOut[0][3] = "Passed Exit Point.";
+			returnOut[1][3] = "Passed " + ExitPointOutput(flightPlan, airport, points);
+		}
+		case 1:
+		{
+			if (round == 1) {
+				returnOut[1][3] = returnOut[0][3] = "Failed " + ExitPointOutput(flightPlan, airport, points);
+			}
+
+			returnOut[0][2] = "Passed Destination.";
+			returnOut[1][2] = "Passed " + DestinationOutput(flightPlan, airport, destination);
+		}
+		case 0:
+		{
+			if (round == 0) {
+				returnOut[1][2] = returnOut[0][2] = "Failed " + DestinationOutput(flightPlan, airport, destination);
+			}
+			break;
+		}
+		}
+	}
+	else {
+		if (result.sidFails[0]) {
+			returnOut[1][6] = returnOut[0][7] = "Invalid " + SuffixOutput(flightPlan, sid_ele);
+		}
+		else {
+			returnOut[0][6] = "Valid Suffix.";
+			returnOut[1][6] = "Valid " + SuffixOutput(flightPlan, sid_ele);
+
+			//sidFails[1], [2], or [3] must be false to get here
+			returnOut[1][8] = returnOut[0][8] = "Failed " + RestrictionsOutput(flightPlan, sid_ele, result.sidFails[1], result.sidFails[2], result.sidFails[3]) + " " + AlternativesOutput(flightPlan, sid_ele);
+		}
+	}
+
+	return returnOut;
+}
+
+//Outputs route bans as string
+string SidChecker::BansOutput(const FlightPlanView& flightPlan, const AirportRules& airport, const vector<ConstraintRule>& constraints, vector<size_t> successes, const vector<StringId>& extracted_route, string dest, int rfl) {
+	StatTimer timer(Metric::BansOutput);
+	vector<string> bans{};
+	for (size_t each : successes) {
+		for (const AlertRule& alert : constraints[each].alerts) {
+			if (alert.ban) {
+				if (alert.hasSrd) {
+					bans.push_back("SRD Note " + to_string(alert.srd));
+				}
+				if (alert.hasNote) {
+					bans.push_back(alert.note);
+				}
+				else {
+					bans.push_back("Alternative Route: " + RouteOutput(flightPlan, airport, constraints, successes, extracted_route, dest, rfl));
+				}
+			}
+		}
+	}
+
+	sort(bans.begin(), bans.end());
+	vector<string>::iterator itr = unique(bans.begin(), bans.end());
+	bans.erase(itr, bans.end());
+
+	string out = "";
+
+	for (string each : bans) {
+		out += each + RESULT_SEP;
+	}
+
+	if (out == "") {
+		out = NO_RESULTS;
+	}
+	else {
+		out = out.substr(0, out.length() - 2);
+	}
+
+	return "Route Banned: " + out + ".";
+}
+
+//Outputs route warnings as string
+string SidChecker::WarningsOutput(const FlightPlanView& flightPlan, const AirportRules& airport, const vector<ConstraintRule>& constraints, vector<size_t> successes, const vector<StringId>& extracted_route, string dest, int rfl) {
+	StatTimer timer(Metric::WarningsOutput);
+	vector<string> warnings{};
+	for (size_t each : successes) {
+		for (const AlertRule& alert : constraints[each].alerts) {
+			if (alert.warn) {
+				if (alert.hasSrd) {
+					warnings.push_back("SRD Note " + to_string(alert.srd));
+				}
+				if (alert.hasNote) {
+					warnings.push_back(alert.note);
+				}
+				else {
+					warnings.push_back("Alternative Route: " + RouteOutput(flightPlan, airport, constraints, successes, extracted_route, dest, rfl));
+				}
+			}
+		}
+	}
+
+	sort(warnings.begin(), warnings.end());
+	vector<string>::iterator itr = unique(warnings.begin(), warnings.end());
+	warnings.erase(itr, warnings.end());
+
+	string out = "";
+
+	for (string each : warnings) {
+		out += each + RESULT_SEP;
+	}
+
+	if (out == "") {
+		out = NO_RESULTS;
+	}
+	else {
+		out = out.substr(0, out.length() - 2);
+	}
+
+	return "Warnings: " + out + ".";
+}
+
+//Outputs recommended alternatives (from Restrictions arrays for a SID) as string
+string SidChecker::AlternativesOutput(const FlightPlanView& flightPlan, const SidRule& sid_ele, vector<size_t> successes) {
+	StatTimer timer(Metric::AlternativesOutput);
+	vector<string> alts{};
+	const vector<ConstraintRule>& constraints = sid_ele.constraints;
+
+	vector<string> temp = AlternativesSingle(sid_ele.restrictions);
+	alts.insert(alts.end(), temp.begin(), temp.end());
+
+	for (size_t each : successes) {
+		temp = AlternativesSingle(constraints[each].restrictions);
+		alts.insert(alts.end(), temp.begin(), temp.end());
+	}
+
+	string out = "Recommended Alternatives: ";
+
+	sort(alts.begin(), alts.end());
+	vector<string>::iterator itr = unique(alts.begin(), alts.end());
+	alts.erase(itr, alts.end());
+
+	if (!alts.size()) {
+		out = NO_RESULTS;
+	}
+	else {
+		for (string each : alts) {
+			out += each + RESULT_SEP;
+		}
+	}
+
+	return out.substr(0, out.size() - 2) + ".";
+}
+
+//Outputs recommended alternatives (from a single Restrictions array) as string
+vector<string> SidChecker::AlternativesSingle(const vector<RestrictionRule>& restrictions) {
+	vector<string> alts{};
+	for (const RestrictionRule& rest : restrictions) {
+		alts.insert(alts.end(), rest.alt.begin(), rest.alt.end());
+	}
+
+	return alts;
+}
+
+//Outputs aircraft type and date/time restrictions (from Restrictions array) as string
+string SidChecker::RestrictionsOutput(const FlightPlanView& flightPlan, const SidRule& sid_ele, bool check_type, bool check_time, bool check_ban, vector<size_t> successes) {
+	StatTimer timer(Metric::RestrictionsOutput);
+	vector<vector<string>> rests{};
+	const vector<ConstraintRule>& constraints = sid_ele.constraints;
+
+	vector<vector<string>> temp = RestrictionsSingle(sid_ele.restrictions);
+	rests.insert(rests.end(), temp.begin(), temp.end());
+
+	for (size_t each : successes) {
+		temp = RestrictionsSingle(constraints[each].restrictions);
+		rests.insert(rests.end(), temp.begin(), temp.end());
+	}
+
+	sort(rests.begin(), rests.end());
+	vector<vector<string>>::iterator itr = unique(rests.begin(), rests.end());
+	rests.erase(itr, rests.end());
+
+	string out = "";
+	for (size_t i = 0; i < rests.size(); i++) {
+		string temp = "";
+		if (check_ban) {
+			temp += "Banned";
+		}
+
+		if (check_type && check_time) {
+			if (temp.size() > 0) {
+				temp += " for ";
+			}
+
+			temp += rests[i][0] + " Between " + rests[i][1] + ROUTE_RESULT_SEP;
+		}
+		else if (check_type) {
+			if (temp.size() > 0) {
+				temp += " for ";
+			}
+
+			temp += rests[i][0] + RESULT_SEP;
+		}
+		else if (check_time) {
+			if (temp.size() > 0) {
+				temp += " b";
+			}
+			else {
+				temp += "B";
+			}
+
+			temp += "etween " + rests[i][1] + ROUTE_RESULT_SEP;
+		}
+
+		out += temp;
+	}
+
+	if (out == "") {
+		out = NO_RESULTS;
+	}
+	else if (check_time) {
+		out = out.substr(0, out.size() - 3);
+	}
+	else {
+		out = out.substr(0, out.size() - 2);
+	}
+
+	return "SID Restrictions: " + out + ".";
+}
+
+vector<vector<string>> SidChecker::RestrictionsSingle(const vector<RestrictionRule>& restrictions, bool check_type, bool check_time, bool check_ban) {
+	vector<vector<string>> rests{};
+
+	for (const RestrictionRule& rest : restrictions) {
+		vector<string> this_rest{ "", "", "" };
+
+		if (rest.types.size()) {
+			for (const string& item : rest.types) {
+				if (item.size() == 1) {
+					if (item == "P") {
+						this_rest[0] += "All Pistons";
+					}
+					else if (item == "T") {
+						this_rest[0] += "All Turboprops";
+					}
+					else if (item == "J") {
+						this_rest[0] += "All Jets";
+					}
+					else if (item == "E") {
+						this_rest[0] += "All Electric Aircraft";
+					}
+				}
+				else {
+					this_rest[0] += item;
+				}
+
+				this_rest[0] += RESULT_SEP;
+			}
+
+			if (this_rest[0] != "") {
+				this_rest[0] = this_rest[0].substr(0, this_rest[0].size() - 2);
+			}
+		}
+
+		if (rest.hasWindow) {
+			string start = "";
+			string end = "";
+
+			if (rest.hasDate) {
+				start += dayIntToString(rest.startDate);
+				end += dayIntToString(rest.endDate);
+			}
+
+			if (rest.hasTime) {
+				if (rest.hasDate) {
+					start += " ";
+					end += " ";
+				}
+
+				start += rest.startTimeText.substr(0, 2) + ":" + rest.startTimeText.substr(2, 2);
+				end += rest.endTimeText.substr(0, 2) + ":" + rest.endTimeText.substr(2, 2);
+			}
+
+			if (start != "" && end != "") {
+				this_rest[1] = start + " and " + end;
+			}
+		}
+
+		if (rest.banned) {
+			this_rest[2] = "Banned";
+		}
+
+		if (!all_of(this_rest[0].begin(), this_rest[0].end(), [](unsigned char c) { return std::isspace(c); }) || 
+			!all_of(this_rest[1].begin(), this_rest[1].end(), [](unsigned char c) { return std::isspace(c); }) || 
+			!all_of(this_rest[2].begin(), this_rest[2].end(), [](unsigned char c) { return std::isspace(c); })) {
+			rests.push_back(this_rest);
+		}
+	}
+
+	return rests;
+}
+
+//Outputs valid suffices (from Restrictions array) as string
+string SidChecker::SuffixOutput(const FlightPlanView& flightPlan, const SidRule& sid_eles, vector<size_t> successes) {
+	StatTimer timer(Metric::SuffixOutput);
+	vector<string> suffices{};
+	const vector<ConstraintRule>& constraints = sid_eles.constraints;
+
+	vector<string> temp = SuffixSingle(sid_eles.restrictions);
+	suffices.insert(suffices.end(), temp.begin(), temp.end());
+
+	for (size_t each : successes) {
+		temp = SuffixSingle(constraints[each].restrictions);
+		suffices.insert(suffices.end(), temp.begin(), temp.end());
+	}
+
+	string out = "Suffix. Valid Suffices: ";
+
+	sort(suffices.begin(), suffices.end());
+	vector<string>::iterator itr = unique(suffices.begin(), suffices.end());
+	suffices.erase(itr, suffices.end());
+	
+	if (!suffices.size()) {
+		out += "Any.";
+	}
+	else {
+		for (string each : suffices) {
+			out += each + RESULT_SEP;
+		}
+
+		out = out.substr(0, out.size() - 2) + ".";
+	}
+
+	return out;
+}
+
+vector<string> SidChecker::SuffixSingle(const vector<RestrictionRule>& restrictions) {
+	vector<string> suffices{};
+
+	for (const RestrictionRule& rest : restrictions) {
+		for (const string& suffix : rest.suffix) {
+			string out = "";
+			if (rest.banned) {
+				out += "Not ";
+			}
+
+			out += suffix;
+			suffices.push_back(out);
+		}
+	}
+
+	return suffices;
+}
+
+//Outputs valid cruise level direction (from Constraints array) as string
+string SidChecker::DirectionOutput(const FlightPlanView& flightPlan, const vector<ConstraintRule>& constraints, vector<size_t> successes) {
+	StatTimer timer(Metric::DirectionOutput);
+	
+	bool lvls[2] { false, false };
+	for (size_t each : successes) {
+		if (constraints[each].dir == LevelDirection::Even) {
+			lvls[0] = true;
+		}
+		else if (constraints[each].dir == LevelDirection::Odd) {
+			lvls[1] = true;
+		}
+		else if (constraints[each].dir == LevelDirection::None) {
+			lvls[0] = true;
+			lvls[1] = true;
+		}
+	}
+
+	string out = "Odd-Even Rule. Required: ";
+
+	if (lvls[0] && lvls[1]) {
+		out += "Any";
+	}
+	else if (lvls[0]) {
+		out += "Even";
+	}
+	else if (lvls[1]) {
+		out += "Odd";
+	}
+	else {
+		out += "Any";
+	}
+
+	return out;
+}
+
+//Outputs valid cruise level blocks (from Constraints array) as string
+string SidChecker::MinMaxOutput(const FlightPlanView& flightPlan, const vector<ConstraintRule>& constraints, vector<size_t> successes) {
+	StatTimer timer(Metric::MinMaxOutput);
+	
+	vector<vector<int>> raw_lvls{};
+	for (size_t each : successes) {
+		vector<int> lvls = { INT_MIN, INT_MAX };
+
+		if (constraints[each].minIsInt) {
+			lvls[0] = constraints[each].min;
+		}
+
+		if (constraints[each].maxIsInt) {
+			lvls[1] = constraints[each].max;
+		}
+
+		raw_lvls.push_back(lvls);
+	}
+
+	bool changed = false;
+	size_t i = 0;
+
+	while (i < raw_lvls.size() - 1) {
+		for (size_t j = 0; j < raw_lvls.size(); j++) {
+			if (i == j) {
+				break;
+			}
+			//Item j is a subset of Item i
+			if (raw_lvls[j][0] >= raw_lvls[i][0] && raw_lvls[j][1] <= raw_lvls[i][1]) {
+				raw_lvls.erase(raw_lvls.begin() + j);
+				changed = true;
+				break;
+			}
+			//Item j extends higher than Item i
+			else if (raw_lvls[j][0] >= raw_lvls[i][0]) {
+				raw_lvls[i][1] = raw_lvls[j][1];
+				raw_lvls.erase(raw_lvls.begin() + j);
+				changed = true;
+				break;
+			}
+			//Item j extends lower than Item i
+			else if (raw_lvls[j][1] <= raw_lvls[i][1]) {
+				raw_lvls[i][0] = raw_lvls[j][0];
+				raw_lvls.erase(raw_lvls.begin() + j);
+				changed = true;
+				break;
+			}
+		}
+
+		if (!changed) {
+			i++;
+		}
+	}
+
+	string out = "Min/Max Level: ";
+
+	for (vector<int> each : raw_lvls) {
+		if (each[0] == INT_MIN && each[1] == INT_MAX) {
+			out += "Any Level, ";
+		}
+		else if (each[0] == INT_MIN) {
+			out += to_string(each[1]) + "-, ";
+		}
+		else if (each[1] == INT_MAX) {
+			out += to_string(each[0]) + "+, ";
+
+		}
+		else {
+			out += to_string(each[0]) + "-" + to_string(each[1]);
+			out += RESULT_SEP;
+		}
+	}
+
+	out = out.substr(0, out.size() - 2) + ".";
+
+	return out;
+}
+
+//Outputs valid initial routes (from Constraints array) as string
+string SidChecker::RouteOutput(const FlightPlanView& flightPlan, const AirportRules& airport, const vector<ConstraintRule>& constraints, vector<size_t> successes, const vector<StringId>& extracted_route, string dest, int rfl, bool req_lvl) {
+	StatTimer timer(Metric::RouteOutput);
+	
+	vector<size_t> pos{};
+	bool lvls = false;
+
+	for (size_t i = 0; i < constraints.size(); i++) {
+		pos.push_back(i);
+	}
+
+	size_t i = 0;
+	while (i < 7) {
+		vector<size_t> newpos{};
+		for (size_t j : pos) {
+			const ConstraintRule& con = constraints[j];
+
+			switch (i) {
+			//Exact dest match
+			case 0: {
+				bool res = false;
+
+				for (const string& each : con.dests) {
+					if (each.size() == 4 && each == dest) {
+						res = true;
+					}
+				}
+
+				for (const string& each : con.nodests) {
+					if (startsWith(each.c_str(), dest.c_str())) {
+						res = false;
+					}
+				}
+
+				if (con.points.size() || con.nopoints.size()) {
+					res = false;
+				}
+
+
+				if (res) {
+					newpos.push_back(j);
+				}
+				break;
+			}
+			//Any dest/nodest match
+			case 1: {
+				bool res = false;
+
+				if (con.dests.size()) {
+					for (const string& each : con.dests) {
+						if (startsWith(each.c_str(), dest.c_str())) {
+							res = true;
+						}
+					}
+				}
+				else {
+					res = true;
+				}
+
+				if (res) {
+					newpos.push_back(j);
+				}
+				break;
+			}
+			case 2: {
+				bool res = true;
+
+				for (const string& each : con.nodests) {
+					if (startsWith(each.c_str(), dest.c_str())) {
+						res = false;
+					}
+				}
+
+				if (res) {
+					newpos.push_back(j);
+				}
+				break;
+			}
+			//points/nopoints match
+			case 3: {
+				bool res = false;
+
+				if (con.points.size()) {
+					for (StringId each : extracted_route) {
+						if (arrayContains(con.points, each)) {
+							res = true;
+						}
+					}
+				}
+				else {
+					res = true;
+				}
+
+				if (res) {
+					newpos.push_back(j);
+				}
+				break;
+			}
+			case 4: {
+				bool res = true;
+
+				for (StringId each : extracted_route) {
+					if (arrayContains(con.nopoints, each)) {
+						res = false;
+					}
+				}
+
+				if (res) {
+					newpos.push_back(j);
+				}
+				break;
+			}
+			//Levels match
+			case 5: {
+				bool res = true;
+
+				if (con.hasMin && (!con.minIsInt || con.min > rfl / 100)) {
+					res = false;
+				}
+
+				if (con.hasMax && (!con.maxIsInt || con.max < rfl / 100)) {
+					res = false;
+				}
+
+				if (res) {
+					newpos.push_back(j);
+					lvls = true;
+				}
+				break;
+			}
+			//Remove anything banned
+			case 6: {
+				bool res = true;
+
+				for (const AlertRule& alert : con.alerts) {
+					if (alert.ban) {
+						res = false;
+					}
+				}
+
+				if (res) {
+					newpos.push_back(j);
+				}
+				break;
+			}
+			}
+		}
+
+		if (newpos.size() > 0) {
+			pos = newpos;
+
+			if (i == 0) {
+				i = 4;
+			}
+		}
+
+		i++;
+	}
+
+	vector<string> out{};
+
+	for (size_t each : pos) {
+		const ConstraintRule& con = constraints[each];
+
+		string positem = "";
+		if (con.routeIsArray) {
+			for (size_t i = 0; i < con.routeText.size(); i++) {
+				if (i > 0) {
+					positem += RESULT_SEP;
+				}
+
+				positem += con.routeText[i];
+			}
+		}
+
+		if (con.pointsIsArray) {
+			if (positem.size() > 0) {
+				positem += " and ";
+			}
+
+			positem += "via ";
+
+			for (size_t i = 0; i < con.points.size(); i++) {
+				if (i > 0) {
+					positem += RESULT_SEP;
+				}
+
+				positem += airport.pool.str(con.points[i]);
+			}
+		}
+
+		string negitem = "";
+		if (con.norouteIsArray || con.nopointsIsArray) {
+
+			if (con.norouteIsArray) {
+				for (size_t i = 0; i < con.norouteText.size(); i++) {
+					if (i > 0) {
+						negitem += RESULT_SEP;
+					}
+
+					negitem += con.norouteText[i];
+				}
+			}
+
+			if (con.nopointsIsArray) {
+				if (negitem.size() > 0) {
+					negitem += " or ";
+				}
+
+				negitem += "via ";
+
+				for (size_t i = 0; i < con.nopoints.size(); i++) {
+					if (i > 0) {
+						negitem += RESULT_SEP;;
+					}
+
+					negitem += airport.pool.str(con.nopoints[i]);
+				}
+			}
+
+		}
+
+		string lvlitem = "";
+		int lvls[2]{ INT_MIN, INT_MAX };
+		if (con.minIsInt) {
+			lvls[0] = con.min;
+		}
+		if (con.maxIsInt) {
+			lvls[1] = con.max;
+		}
+
+		if (lvls[0] == INT_MIN && lvls[1] == INT_MAX) {
+			lvlitem = "Any Level";
+		}
+		else if (lvls[0] == INT_MIN) {
+			lvlitem = to_string(lvls[1]) + "-";
+		}
+		else if (lvls[1] == INT_MAX) {
+			lvlitem = to_string(lvls[0]) + "+";
+
+		}
+		else {
+			lvlitem = to_string(lvls[0]) + "-" + to_string(lvls[1]);
+		}
+
+
+		if (positem.size() > 0 || negitem.size() > 0) {
+			if (negitem.size() > 0) {
+				negitem += "not ";
+
+				if (positem.size() > 0) {
+					positem += " but ";
+				}
+			}
+
+			if (lvlitem.size() > 0) {
+				negitem += " ";
+			}
+		}
+
+
+		out.push_back(positem + negitem + "(" + lvlitem + ")");
+	}
+
+	string outstring = "";
+
+	if (pos.size() == 0 || (req_lvl && !lvls)) {
+		outstring = NO_RESULTS;
+	}
+	else {
+		for (string each : out) {
+			outstring += each + " / ";
+		}
+
+		outstring = outstring.substr(0, outstring.length() - 3);
+	}
+
+	return "Valid Initial Routes: " + outstring + ".";
+}
+
+//Outputs valid FIR exit points (from Constraints array) as string
+string SidChecker::ExitPointOutput(const FlightPlanView& flightPlan, const AirportRules& airport, const vector<StringId>& points) {
+	StatTimer timer(Metric::ExitPointOutput);
+	
+	map<string, vector<string>> a{}; //Key = Exit Point, Value = Explicitly Permitted SIDs
+	vector<bool> b{}; //Implicitly Permitted SIDs (Not Explicitly Prohibited)
+
+	for (size_t i = 0; i < airport.sids.size(); i++) {
+		b.push_back(false);
+
+		const SidRule& sid = airport.sids[i];
+		if (sid.hasPoint) {
+			const vector<ConstraintRule>& conditions = sid.constraints;
+			for (size_t j = 0; j < conditions.size(); j++) {
+				if (conditions[j].points.size()) {
+					for (StringId each : points) {
+						if (arrayContains(conditions[j].points, each)) {
+							a[airport.pool.str(each)].push_back(sid.point);
+						}
+					}
+				}
+				else if (conditions[j].nopoints.size()) {
+					b[i] = true;
+					for (StringId each : points) {
+						if (arrayContains(conditions[j].nopoints, each)) {
+							b[i] = false;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	vector<string> out = {};
+
+	if (a.size()) {
+		for (pair<string, vector<string>> exit : a) {
+			string single = "";
+
+			for (string each : exit.second) {
+				if (each == "") {
+					single += "No SID";
+				}
+				else {
+					single += each;
+				}
+
+				single += RESULT_SEP;
+			}
+
+			if (single.size() > 0) {
+				single = single.substr(0, single.size() - RESULT_SEP.size());
+			}
+			else {
+				single = "None";
+			}
+
+			string prefix = exit.first;
+			prefix += " is valid for: ";
+
+			out.push_back(prefix + single);
+		}
+	}
+
+	if (!all_of(b.begin(), b.end(), [](bool v) { return !v; })) {
+		string single = "";
+
+		for (size_t i = 0; i < b.size(); i++) {
+			if (b[i]) {
+				string temp = airport.sids[i].point;
+
+				if (temp == "") {
+					single += "No SID";
+				}
+				else {
+					single += temp;
+				}
+				single += RESULT_SEP;
+			}
+		}
+
+		if (single.size() > 0) {
+			single = single.substr(0, single.size() - RESULT_SEP.size());
+		}
+		else {
+			single = "None";
+		}
+
+		string prefix = "";
+		if (out.size()) {
+			prefix += "Additionally, t";
+		}
+		else {
+			prefix += "T";
+		}
+
+		prefix += "he following SIDs may perhaps be valid: ";
+
+		out.push_back(prefix + single);
+	}
+
+	string outstring = "";
+	for (string each : out) {
+		outstring += each + ". ";
+	}
+
+	if (!outstring.size()) {
+		outstring = "Not Found. ";
+	}
+
+	return "Exit Point. " + outstring.substr(0, outstring.size() - 1);
+}
+
+//Outputs valid destinations (from Constraints array) as string
+string SidChecker::DestinationOutput(const FlightPlanView& flightPlan, const AirportRules& airport, string dest) {
+	StatTimer timer(Metric::DestinationOutput);
+	
+	vector<string> a{}; //Explicitly Permitted
+	vector<string> b{}; //Implicitly Permitted (Not Explicitly Prohibited)
+
+	for (const SidRule& sid : airport.sids) {
+		if (sid.hasPoint) {
+			bool push_a = false;
+			bool push_b = false;
+
+			for (const ConstraintRule& con : sid.constraints) {
+				if (con.dests.size()) {
+					if (destArrayContains(con.dests, dest) != "") {
+						push_a = true;
+					}
+				}
+				else if (con.nodests.size()) {
+					if (destArrayContains(con.nodests, dest) == "") {
+						push_b = true;
+					}
+				}
+			}
+
+			string sidstr = sid.point;
+			if (sidstr == "") {
+				sidstr = "No SID";
+			}
+
+			if (push_a) {
+				a.push_back(sidstr);
+			}
+			else if (push_b) {
+				b.push_back(sidstr);
+			}
+		}
+	}
+
+	string out = "";
+
+	if (a.size()) {
+		out += "is valid for: ";
+
+		for (string each : a) {
+			out += each;
+			out += RESULT_SEP;
+		}
+
+		out = out.substr(0, out.size() - 2) + ".";
+	}
+
+	if (b.size()) {
+		if (a.size()) {
+			out += " Additionally, " + dest + " ";
+		}
+
+		out += "may be valid for: ";
+
+		for (string each : b) {
+			out += each;
+			out += RESULT_SEP;
+		}
+
+		out = out.substr(0, out.size() - 2) + ".";
+	}
+
+	if (out == "") {
+		out = "No valid SIDs found for " + dest + out;
+	}
+	else {
+		out = dest + " " + out;
+	}
+
+	return "Destination. " + out;
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include "Constant.hpp"
+#include "ruleModel.hpp"
+#include "constraintSet.hpp"
+#include "ruleSnapshot.hpp"
+#include "routeLexer.hpp"
+#include "checkResult.hpp"
+#include "flightPlanView.hpp"
+#include "perfStats.hpp"
+
+/***********************************************************
+* Flight plan checker core.
+*
+* Validates a FlightPlanView against a rule snapshot and
+* builds the explanatory text, with no EuroScope or Win32
+* dependency, so it is built as its own static library
+* (VFPCCore) and shared by the plugin and the command line
+* tools. Holds no state besides the log hook, so one checker
+* may be used from several threads at once as long as the
+* hook is thread safe.
+***********************************************************/
+
+using namespace std;
+
+template <typename Out>
+void split(const string& s, char delim, Out result) {
+	istringstream iss(s);
+	string item;
+	while (getline(iss, item, delim)) {
+		*result++ = item;
+	}
+}
+
+inline vector<string> split(const string& s, char delim) {
+	vector<string> elems;
+	split(s, delim, back_inserter(elems));
+	return elems;
+}
+
+class SidChecker {
+public:
+	typedef function<void(const string&)> LogHook;
+
+	explicit SidChecker(LogHook log = nullptr) : logHook(log) {}
+
+	//Runs every check. minuteOfWeek (0 = Monday 0000) is the time restriction windows are evaluated at.
+	CheckResult validateSid(const FlightPlanView& flightPlan, const RuleSnapshot& rules, int minuteOfWeek);
+
+	//Builds the explanatory text for a check result. out[0] = Normal Output, out[1] = Debug Output
+	vector<vector<string>> explainCheck(const FlightPlanView& flightPlan, const CheckResult& result, const RuleSnapshot& rules);
+
+	void checkDestination(const SidIndex& index, string destination, ConstraintSet& candidates);
+
+	void checkExitPoint(const SidIndex& index, const vector<StringId>& extracted_route, ConstraintSet& candidates);
+
+	void checkRoute(const SidIndex& index, const vector<StringId>& route, ConstraintSet& candidates);
+
+	vector<bool> checkRestriction(const FlightPlanView& flightPlan, string sid_suffix, const vector<RestrictionRule>& restrictions, bool *sidfails, bool* fails, int minuteOfWeek, int* windowChange);
+
+	void checkRestrictions(const FlightPlanView& flightPlan, const vector<ConstraintRule>& conditions, string sid_suffix, bool *sidfails, bool* fails, bool *sidwide, int minuteOfWeek, int* windowChange, ConstraintSet& candidates);
+
+	void checkMinMax(const vector<ConstraintRule>& constraints, int RFL, ConstraintSet& candidates);
+
+	void checkDirection(const vector<ConstraintRule>& constraints, int RFL, ConstraintSet& candidates);
+
+	void checkAlerts(const vector<ConstraintRule>& constraints, bool *warn, ConstraintSet& candidates);
+
+	string BansOutput(const FlightPlanView& flightPlan, const AirportRules& airport, const vector<ConstraintRule>& constraints, vector<size_t> successes, const vector<StringId>& extracted_route, string dest, int rfl);
+
+	string WarningsOutput(const FlightPlanView& flightPlan, const AirportRules& airport, const vector<ConstraintRule>& constraints, vector<size_t> successes, const vector<StringId>& extracted_route, string dest, int rfl);
+
+	string AlternativesOutput(const FlightPlanView& flightPlan, const SidRule& sid_ele, vector<size_t> successes = {});
+
+	vector<string> AlternativesSingle(const vector<RestrictionRule>& restrictions);
+
+	string RestrictionsOutput(const FlightPlanView& flightPlan, const SidRule& sid_ele, bool check_type = true, bool check_time = true, bool check_ban = true, vector<size_t> successes = {});
+
+	vector<vector<string>> RestrictionsSingle(const vector<RestrictionRule>& restrictions, bool check_type = true, bool check_time = true, bool check_ban = true);
+
+	string SuffixOutput(const FlightPlanView& flightPlan, const SidRule& sid_ele, vector<size_t> successes = {});
+
+	vector<string> SuffixSingle(const vector<RestrictionRule>& restrictions);
+
+	string DirectionOutput(const FlightPlanView& flightPlan, const vector<ConstraintRule>& constraints, vector<size_t> successes);
+
+	string MinMaxOutput(const FlightPlanView& flightPlan, const vector<ConstraintRule>& constraints, vector<size_t> successes);
+
+	string RouteOutput(const FlightPlanView& flightPlan, const AirportRules& airport, const vector<ConstraintRule>& constraints, vector<size_t> successes, const vector<StringId>& extracted_route, string dest, int rfl, bool req_lvl = false);
+
+	string ExitPointOutput(const FlightPlanView& flightPlan, const AirportRules& airport, const vector<StringId>& extracted_route);
+
+	string DestinationOutput(const FlightPlanView& flightPlan, const AirportRules& airport, string dest);
+
+	//Joins one line of explainCheck output as shown to the user: every stage with something to say (if stages), then Passed/Failed
+	static string joinExplanation(const vector<string>& out, bool stages) {
+		string joined{};
+
+		if (stages) {
+			for (size_t i = 1; i < out.size() - 1; i++) {
+				if (out[i] != "-") {
+					joined += out[i];
+					joined += " | ";
+				}
+			}
+		}
+
+		return joined + out.back();
+	}
+
+	string destArrayContains(const vector<string>& a, const string& s) {
+		for (const string& each : a) {
+			if (s.compare(0, each.size(), each) == 0)
+				return each;
+		}
+		return "";
+	}
+
+	bool arrayContains(const vector<StringId>& a, StringId s) {
+		return find(a.begin(), a.end(), s) != a.end();
+	}
+
+	bool arrayContainsEnding(const vector<string>& a, const string& s) {
+		for (const string& comp : a) {
+			if (comp.size() <= s.size() && s.compare(s.size() - comp.size(), comp.size(), comp) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	string dayIntToString(int day) {
+		switch (day) {
+		case 0:
+			return "Monday";
+		case 1:
+			return "Tuesday";
+		case 2:
+			return "Wednesday";
+		case 3:
+			return "Thursday";
+		case 4:
+			return "Friday";
+		case 5:
+			return "Saturday";
+		case 6:
+			return "Sunday";
+		default:
+			return "Out of Range";
+		}
+	}
+
+	inline const char * const BoolToString(bool b)
+	{
+		return b ? "true" : "false";
+	}
+
+private:
+	void bufLog(const string& message) {
+		if (logHook) {
+			logHook(message);
+		}
+	}
+
+	LogHook logHook;
+};
@@ -0,0 +1,34 @@
+#include "tagCheck.hpp"
+
+using namespace std;
+
+CheckKey makeCheckKey(const FlightPlanView& view, const RuleSnapshot& rules) {
+	CheckKey key;
+
+	key.route = view.route;
+	key.sid = view.sid;
+	key.origin = view.origin;
+	key.destination = view.destination;
+	key.planType = view.planType;
+	key.rfl = view.rfl;
+	key.aircraftType = view.aircraftType;
+	key.engineType = view.engineType;
+	key.generation = rules.generation;
+
+	return key;
+}
+
+const CheckResult& cachedCheck(SidChecker& checker, ResultCache<CheckResult>& cache, FlightPlanView& view, const CheckKey& key, const RuleSnapshot& rules, int minuteOfWeek, const PointsReader& readPoints) {
+	const CheckResult* cached = cache.find(view.callsign, key, minuteOfWeek);
+	if (cached) {
+		return *cached;
+	}
+
+	//Only needed when a check is actually run
+	if (readPoints) {
+		readPoints(view);
+	}
+
+	CheckResult result = checker.validateSid(view, rules, minuteOfWeek);
+	return cache.store(view.callsign, key, result, minuteOfWeek, result.windowChange);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <functional>
+#include "flightPlanView.hpp"
+#include "ruleSnapshot.hpp"
+#include "checkResult.hpp"
+#include "resultCache.hpp"
+#include "sidChecker.hpp"
+
+/***********************************************************
+* Departure list tag item path.
+*
+* What the plugin does for each flight plan on the list,
+* minus the EuroScope calls: build the cache key, reuse the
+* cached result if nothing changed, and only then read the
+* extracted route and run the checker. The plugin splits this
+* between OnGetTagItem, which only ever reads the cache, and
+* its validator threads; the replay tool runs both in line so
+* it measures the whole cost.
+***********************************************************/
+
+typedef std::function<void(FlightPlanView&)> PointsReader;
+
+//(S/D)VFR plans are not checked
+inline bool isVfrPlan(const std::string& planType) {
+	return planType == "V" || planType == "S" || planType == "D";
+}
+
+//Collects the flight plan fields validateSid reads, used to decide whether a cached result is still current
+CheckKey makeCheckKey(const FlightPlanView& view, const RuleSnapshot& rules);
+
+//Cached result for key if still current at minuteOfWeek, else fills view.points with readPoints, runs the checker and caches the result
+const CheckResult& cachedCheck(SidChecker& checker, ResultCache<CheckResult>& cache, FlightPlanView& view, const CheckKey& key, const RuleSnapshot& rules, int minuteOfWeek, const PointsReader& readPoints);
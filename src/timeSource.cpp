@@ -0,0 +1,117 @@
+#include "timeSource.hpp"
+#include <chrono>
+#include <cstdlib>
+
+using namespace std;
+
+//Days since 1970-01-01 of a calendar date (Howard Hinnant's days_from_civil)
+static long long daysFromCivil(int y, int m, int d) {
+	y -= m <= 2;
+	const long long era = (y >= 0 ? y : y - 399) / 400;
+	const unsigned yoe = static_cast<unsigned>(y - era * 400);
+	const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+//Inverse of daysFromCivil
+CivilTime civilFromEpoch(long long seconds) {
+	long long days = seconds / 86400;
+	long long rem = seconds % 86400;
+	if (rem < 0) {
+		rem += 86400;
+		days--;
+	}
+
+	CivilTime out;
+	out.hour = static_cast<int>(rem / 3600);
+	out.minute = static_cast<int>(rem % 3600 / 60);
+
+	//1970-01-01 was a Thursday
+	out.weekday = static_cast<int>(((days + 3) % 7 + 7) % 7);
+
+	long long z = days + 719468;
+	const long long era = (z >= 0 ? z : z - 146096) / 146097;
+	const unsigned doe = static_cast<unsigned>(z - era * 146097);
+	const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const unsigned mp = (5 * doy + 2) / 153;
+
+	out.day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+	out.month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+	out.year = static_cast<int>(static_cast<long long>(yoe) + era * 400 + (out.month <= 2));
+
+	return out;
+}
+
+//0100 UTC on the last Sunday of the month
+static long long lastSundayChange(int year, int month) {
+	int nextYear = month == 12 ? year + 1 : year;
+	int nextMonth = month == 12 ? 1 : month + 1;
+	long long last = daysFromCivil(nextYear, nextMonth, 1) - 1;
+
+	//Weekday of last, 0 = Monday
+	long long weekday = ((last + 3) % 7 + 7) % 7;
+	last -= (weekday + 1) % 7;
+
+	return last * 86400 + 3600;
+}
+
+bool britishSummerTime(long long utcSeconds) {
+	int year = civilFromEpoch(utcSeconds).year;
+	return utcSeconds >= lastSundayChange(year, 3) && utcSeconds < lastSundayChange(year, 10);
+}
+
+long long TimeSource::epochSeconds() {
+	return chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+CivilTime TimeSource::now() const {
+	long long seconds = epochSeconds() + correctionMinutes.load() * 60LL;
+
+	if (basis() == TimeBasis::London && britishSummerTime(seconds)) {
+		seconds += 3600;
+	}
+
+	return civilFromEpoch(seconds);
+}
+
+int TimeSource::minuteOfWeek() const {
+	int fixed = overrideMinute.load();
+	if (fixed >= 0) {
+		return fixed;
+	}
+
+	return now().minuteOfWeek();
+}
+
+//Signed difference between two minutes of the week, taking the shorter way round
+static int weekDifference(int a, int b) {
+	int diff = ((a - b) % MINUTES_PER_WEEK + MINUTES_PER_WEEK) % MINUTES_PER_WEEK;
+	return diff >= MINUTES_PER_WEEK / 2 ? diff - MINUTES_PER_WEEK : diff;
+}
+
+int TimeSource::calibrate(int day, int minute) {
+	long long seconds = epochSeconds();
+	int server = day * 1440 + minute;
+	int utc = civilFromEpoch(seconds).minuteOfWeek();
+
+	int skew = weekDifference(server, utc);
+
+	//In winter the two bases are the same, so keep whichever was last seen
+	if (britishSummerTime(seconds)) {
+		int london = (utc + 60) % MINUTES_PER_WEEK;
+		int londonSkew = weekDifference(server, london);
+
+		if (abs(londonSkew) < abs(skew)) {
+			basisValue = static_cast<int>(TimeBasis::London);
+			skew = londonSkew;
+		}
+		else {
+			basisValue = static_cast<int>(TimeBasis::UTC);
+		}
+	}
+
+	correctionMinutes = abs(skew) > SKEW_TOLERANCE ? skew : 0;
+	return skew;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+
+/***********************************************************
+* Local clock for restriction time windows.
+*
+* Time windows are evaluated against the PC clock in either
+* UTC or UK local time (Europe/London - GMT, or BST from 0100
+* UTC on the last Sunday of March to 0100 UTC on the last
+* Sunday of October), so they are correct to the minute
+* rather than only as fresh as the last API poll.
+*
+* The API server's time is only used to calibrate: it tells us
+* which of the two the data is written against, and how far the
+* PC clock is out. A skew beyond SKEW_TOLERANCE minutes is
+* corrected for.
+*
+* now() and minuteOfWeek() may be called from any thread.
+***********************************************************/
+
+enum class TimeBasis : int {
+	UTC,
+	London
+};
+
+struct CivilTime {
+	int year = 1970;
+	int month = 1;
+	int day = 1;
+	int hour = 0;
+	int minute = 0;
+	int weekday = 0; //0 = Monday
+
+	int minuteOfWeek() const { return weekday * 1440 + hour * 60 + minute; }
+};
+
+const int MINUTES_PER_WEEK = 7 * 1440;
+
+//Breaks seconds since 1970-01-01 00:00 UTC down into a calendar date/time
+CivilTime civilFromEpoch(long long seconds);
+
+//Whether UK summer time (BST) is in force at the given UTC instant
+bool britishSummerTime(long long utcSeconds);
+
+class TimeSource {
+public:
+	static const int SKEW_TOLERANCE = 2; //Minutes - server time only has minute resolution and arrives after a round trip
+
+	//Current time in the calibrated basis, skew corrected
+	CivilTime now() const;
+
+	int minuteOfWeek() const;
+
+	//Compares a server-reported day (0 = Monday) and minute past midnight with the local clock
+	//Picks the matching basis, stores the correction and returns the skew in minutes
+	int calibrate(int day, int minute);
+
+	TimeBasis basis() const { return static_cast<TimeBasis>(basisValue.load()); }
+
+	int correction() const { return correctionMinutes.load(); }
+
+	//Pins the clock to a fixed minute of the week (for replaying traffic), or -1 to follow the PC clock again
+	void setOverride(int minuteOfWeek) { overrideMinute = minuteOfWeek; }
+
+private:
+	static long long epochSeconds();
+
+	std::atomic<int> basisValue{ static_cast<int>(TimeBasis::UTC) };
+	std::atomic<int> correctionMinutes{ 0 };
+	std::atomic<int> overrideMinute{ -1 };
+};
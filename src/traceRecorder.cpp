@@ -0,0 +1,108 @@
+#include "traceRecorder.hpp"
+#include <fstream>
+
+using namespace std;
+
+int TraceRecorder::threadNumber() {
+	static atomic<int> next{ 1 };
+	thread_local int number = next++;
+	return number;
+}
+
+void TraceRecorder::start(size_t maxEvents) {
+	lock_guard<mutex> guard(lock);
+
+	events.clear();
+	events.reserve(maxEvents < 65536 ? maxEvents : 65536);
+	capacity = maxEvents;
+	lost = 0;
+	origin = Clock::now();
+	activeFlag = true;
+}
+
+void TraceRecorder::stop() {
+	activeFlag = false;
+}
+
+void TraceRecorder::complete(const char* name, const char* category, Clock::time_point begin, Clock::time_point end) {
+	Event event;
+	event.name = name;
+	event.category = category;
+	event.thread = threadNumber();
+
+	lock_guard<mutex> guard(lock);
+
+	//Started before the recording did
+	if (!active() || begin < origin) {
+		return;
+	}
+
+	if (events.size() >= capacity) {
+		lost++;
+		return;
+	}
+
+	event.begin = chrono::duration_cast<chrono::microseconds>(begin - origin).count();
+	event.duration = chrono::duration_cast<chrono::microseconds>(end - begin).count();
+	events.push_back(event);
+}
+
+void TraceRecorder::nameThread(const string& name) {
+	int number = threadNumber();
+
+	lock_guard<mutex> guard(lock);
+	threadNames[number] = name;
+}
+
+//Names and categories are fixed strings of ours, but the thread names are not
+static string escape(const string& s) {
+	string out;
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			out += '\\';
+		}
+		if (static_cast<unsigned char>(c) >= 0x20) {
+			out += c;
+		}
+	}
+	return out;
+}
+
+bool TraceRecorder::write(const string& path) {
+	ofstream out(path.c_str(), ios::binary | ios::trunc);
+	if (!out.is_open()) {
+		return false;
+	}
+
+	lock_guard<mutex> guard(lock);
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"VFPC\"}}";
+
+	for (const auto& each : threadNames) {
+		out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << each.first << ",\"args\":{\"name\":\"" << escape(each.second) << "\"}}";
+	}
+
+	for (const Event& event : events) {
+		out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":" << event.begin
+			<< ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":" << event.thread << "}";
+	}
+
+	out << "\n]}\n";
+	return static_cast<bool>(out);
+}
+
+size_t TraceRecorder::size() {
+	lock_guard<mutex> guard(lock);
+	return events.size();
+}
+
+size_t TraceRecorder::dropped() {
+	lock_guard<mutex> guard(lock);
+	return lost;
+}
+
+TraceRecorder& traceRecorder() {
+	static TraceRecorder instance;
+	return instance;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <map>
+
+/***********************************************************
+* Chrome/Perfetto trace-event recorder.
+*
+* While started, every StatTimer scope (see perfStats.hpp)
+* is also kept as a complete ("X") event on the thread that
+* ran it, so tag rendering on the EuroScope thread can be
+* seen side by side with the web call worker and the log
+* writer. Threads are numbered as they first record and may
+* be named. Events are held in memory, up to a cap, and
+* written out as trace JSON - open it in chrome://tracing or
+* ui.perfetto.dev.
+***********************************************************/
+
+class TraceRecorder {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	bool active() const { return activeFlag.load(std::memory_order_relaxed); }
+
+	//Clears anything recorded and starts recording, keeping at most maxEvents
+	void start(size_t maxEvents);
+
+	//Stops recording - what was recorded is kept for write
+	void stop();
+
+	//Adds a complete event on the calling thread
+	void complete(const char* name, const char* category, Clock::time_point begin, Clock::time_point end);
+
+	//Names the calling thread in the trace
+	void nameThread(const std::string& name);
+
+	//Writes the recorded events as trace JSON. Returns false if path can't be written.
+	bool write(const std::string& path);
+
+	size_t size();
+
+	size_t dropped();
+
+private:
+	struct Event {
+		const char* name;
+		const char* category;
+		long long begin; //Microseconds since start
+		long long duration;
+		int thread;
+	};
+
+	static int threadNumber();
+
+	std::atomic<bool> activeFlag{ false };
+	std::mutex lock;
+	Clock::time_point origin;
+	std::vector<Event> events;
+	size_t capacity = 0;
+	size_t lost = 0;
+	std::map<int, std::string> threadNames;
+};
+
+//Process-wide instance
+TraceRecorder& traceRecorder();
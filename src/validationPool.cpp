@@ -0,0 +1,76 @@
+#include "validationPool.hpp"
+#include "perfStats.hpp"
+
+using namespace std;
+
+ValidationPool::ValidationPool(SidChecker& checker, unsigned threads) : checker(checker) {
+	for (unsigned i = 0; i < (threads ? threads : 1); i++) {
+		workers.push_back(thread(&ValidationPool::run, this));
+	}
+}
+
+ValidationPool::~ValidationPool() {
+	stop();
+}
+
+void ValidationPool::submit(Job job) {
+	{
+		lock_guard<mutex> guard(lock);
+		if (stopping) {
+			return;
+		}
+		jobs.push_back(move(job));
+	}
+	wake.notify_one();
+}
+
+void ValidationPool::collect(vector<Done>& out) {
+	lock_guard<mutex> guard(lock);
+
+	for (Done& each : done) {
+		out.push_back(move(each));
+	}
+	done.clear();
+}
+
+void ValidationPool::stop() {
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+		jobs.clear();
+	}
+	wake.notify_all();
+
+	for (thread& each : workers) {
+		if (each.joinable()) {
+			each.join();
+		}
+	}
+	workers.clear();
+}
+
+void ValidationPool::run() {
+	traceRecorder().nameThread("Validator");
+
+	unique_lock<mutex> guard(lock);
+
+	while (true) {
+		wake.wait(guard, [this] { return stopping || !jobs.empty(); });
+		if (stopping) {
+			return;
+		}
+
+		Job job = move(jobs.front());
+		jobs.pop_front();
+		guard.unlock();
+
+		Done out;
+		out.callsign = job.view.callsign;
+		out.key = job.key;
+		out.minuteOfWeek = job.minuteOfWeek;
+		out.result = checker.validateSid(job.view, *job.rules, job.minuteOfWeek);
+
+		guard.lock();
+		done.push_back(move(out));
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "flightPlanView.hpp"
+#include "ruleSnapshot.hpp"
+#include "resultCache.hpp"
+#include "checkResult.hpp"
+#include "sidChecker.hpp"
+
+/***********************************************************
+* Background flight plan validation.
+*
+* The EuroScope thread reads the flight plans (the SDK may
+* only be used from there) and submits the ones whose inputs
+* changed. Worker threads run the checker against the rule
+* snapshot each job carries, and finished results wait in a
+* queue until the EuroScope thread collects them into its
+* result cache - so the cache itself is still only ever
+* touched from one thread.
+***********************************************************/
+
+class ValidationPool {
+public:
+	struct Job {
+		FlightPlanView view; //Including the extracted route
+		CheckKey key;
+		RuleSnapshotPtr rules;
+		int minuteOfWeek = 0; //Restriction windows are evaluated at
+	};
+
+	struct Done {
+		std::string callsign;
+		CheckKey key;
+		CheckResult result;
+		int minuteOfWeek = 0;
+	};
+
+	ValidationPool(SidChecker& checker, unsigned threads);
+
+	~ValidationPool();
+
+	void submit(Job job);
+
+	//Moves every finished result into out
+	void collect(std::vector<Done>& out);
+
+	//Drops queued jobs and joins the workers - results still running are discarded
+	void stop();
+
+private:
+	void run();
+
+	SidChecker& checker;
+	std::vector<std::thread> workers;
+	std::deque<Job> jobs;
+	std::vector<Done> done;
+	bool stopping = false;
+	std::mutex lock;
+	std::condition_variable wake;
+};
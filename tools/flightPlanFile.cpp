@@ -0,0 +1,319 @@
+#include "flightPlanFile.hpp"
+#include "routeLexer.hpp"
+#include "ruleImage.hpp"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+#include <cctype>
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+using namespace std;
+using namespace rapidjson;
+
+static bool endsWith(const string& s, const string& suffix) {
+	return s.size() >= suffix.size() && equal(suffix.rbegin(), suffix.rend(), s.rbegin(), [](char a, char b) { return tolower(a) == tolower(b); });
+}
+
+static string trim(const string& s) {
+	size_t start = s.find_first_not_of(" \t\r\n");
+	if (start == string::npos) {
+		return "";
+	}
+
+	size_t end = s.find_last_not_of(" \t\r\n");
+	string out = s.substr(start, end - start + 1);
+
+	//CSV quoting - fields here never contain commas or quotes
+	if (out.size() >= 2 && out.front() == '"' && out.back() == '"') {
+		out = out.substr(1, out.size() - 2);
+	}
+
+	return out;
+}
+
+static vector<string> splitFields(const string& line, char delim) {
+	vector<string> out{};
+	istringstream iss(line);
+	string item;
+	while (getline(iss, item, delim)) {
+		out.push_back(trim(item));
+	}
+	return out;
+}
+
+static int toInt(const string& s) {
+	try {
+		return s.size() ? stoi(s) : 0;
+	}
+	catch (...) {
+		return 0;
+	}
+}
+
+//Sets one field by name, from its text. Unknown names are ignored.
+static void setField(FlightPlanView& fp, const string& name, const string& value) {
+	if (name == "callsign") fp.callsign = value;
+	else if (name == "origin") fp.origin = value;
+	else if (name == "destination") fp.destination = value;
+	else if (name == "route") fp.route = value;
+	else if (name == "sid") fp.sid = value;
+	else if (name == "planType") fp.planType = value;
+	else if (name == "rfl") fp.rfl = toInt(value);
+	else if (name == "aircraftType") fp.aircraftType = value.size() ? value[0] : 0;
+	else if (name == "engineType") fp.engineType = value.size() ? value[0] : 0;
+	else if (name == "points") {
+		for (const string& each : splitFields(value, ' ')) {
+			if (each.size()) {
+				fp.points.push_back(each);
+			}
+		}
+	}
+}
+
+static void finishFlightPlan(FlightPlanView& fp, bool hasPoints) {
+	if (fp.planType.empty()) {
+		fp.planType = "I";
+	}
+
+	if (!hasPoints) {
+		routePoints(fp);
+	}
+}
+
+//Fills fp from a JSON object of flight plan fields. Returns whether it has a points member.
+static bool readFlightPlanObject(const Value& object, FlightPlanView& fp) {
+	bool hasPoints = false;
+
+	for (Value::ConstMemberIterator it = object.MemberBegin(); it != object.MemberEnd(); ++it) {
+		string name = it->name.GetString();
+		const Value& value = it->value;
+
+		if (name == "points" && value.IsArray()) {
+			hasPoints = true;
+			for (SizeType i = 0; i < value.Size(); i++) {
+				if (value[i].IsString()) {
+					fp.points.push_back(value[i].GetString());
+				}
+			}
+		}
+		else if (value.IsString()) {
+			hasPoints |= name == "points";
+			setField(fp, name, value.GetString());
+		}
+		else if (value.IsInt()) {
+			setField(fp, name, to_string(value.GetInt()));
+		}
+	}
+
+	return hasPoints;
+}
+
+static bool readJsonLines(istream& in, vector<FlightPlanView>& out, string& error) {
+	string line;
+	for (size_t n = 1; getline(in, line); n++) {
+		if (trim(line).empty()) {
+			continue;
+		}
+
+		Document doc;
+		if (doc.Parse<0>(line.c_str()).HasParseError() || !doc.IsObject()) {
+			error = "Line " + to_string(n) + ": Not A JSON Object";
+			return false;
+		}
+
+		FlightPlanView fp;
+		finishFlightPlan(fp, readFlightPlanObject(doc, fp));
+		out.push_back(fp);
+	}
+
+	return true;
+}
+
+static bool readCsv(istream& in, vector<FlightPlanView>& out, string& error) {
+	string line;
+	if (!getline(in, line)) {
+		error = "Empty File";
+		return false;
+	}
+
+	vector<string> header = splitFields(line, ',');
+	for (const char* required : { "callsign", "origin", "route" }) {
+		if (find(header.begin(), header.end(), required) == header.end()) {
+			error = string("Header Has No \"") + required + "\" Column";
+			return false;
+		}
+	}
+
+	bool hasPoints = find(header.begin(), header.end(), "points") != header.end();
+
+	while (getline(in, line)) {
+		if (trim(line).empty()) {
+			continue;
+		}
+
+		vector<string> fields = splitFields(line, ',');
+		FlightPlanView fp;
+
+		for (size_t i = 0; i < header.size() && i < fields.size(); i++) {
+			setField(fp, header[i], fields[i]);
+		}
+
+		finishFlightPlan(fp, hasPoints);
+		out.push_back(fp);
+	}
+
+	return true;
+}
+
+bool readFlightPlans(const string& path, vector<FlightPlanView>& out, string& error) {
+	ifstream in(path.c_str(), ios::binary);
+	if (!in.is_open()) {
+		error = path + " Not Found";
+		return false;
+	}
+
+	return endsWith(path, ".csv") ? readCsv(in, out, error) : readJsonLines(in, out, error);
+}
+
+bool readRecording(const string& path, vector<RecordedState>& out, string& error) {
+	ifstream in(path.c_str(), ios::binary);
+	if (!in.is_open()) {
+		error = path + " Not Found";
+		return false;
+	}
+
+	string line;
+	for (size_t n = 1; getline(in, line); n++) {
+		if (trim(line).empty()) {
+			continue;
+		}
+
+		Document doc;
+		if (doc.Parse<0>(line.c_str()).HasParseError() || !doc.IsObject()) {
+			error = "Line " + to_string(n) + ": Not A JSON Object";
+			return false;
+		}
+
+		RecordedState state;
+		if (doc.HasMember("t") && doc["t"].IsNumber()) {
+			state.time = doc["t"].GetDouble();
+		}
+		state.disconnect = doc.HasMember("disconnect") && doc["disconnect"].IsBool() && doc["disconnect"].GetBool();
+
+		finishFlightPlan(state.fp, readFlightPlanObject(doc, state.fp));
+
+		if (state.fp.callsign.empty()) {
+			error = "Line " + to_string(n) + ": No Callsign";
+			return false;
+		}
+
+		out.push_back(state);
+	}
+
+	stable_sort(out.begin(), out.end(), [](const RecordedState& a, const RecordedState& b) { return a.time < b.time; });
+	return true;
+}
+
+bool writeFlightPlans(const string& path, const vector<FlightPlanView>& flights, string& error) {
+	ofstream out(path.c_str(), ios::binary);
+	if (!out.is_open()) {
+		error = path + " Not Writable";
+		return false;
+	}
+
+	for (const FlightPlanView& fp : flights) {
+		StringBuffer buffer;
+		Writer<StringBuffer> writer(buffer);
+
+		writer.StartObject();
+		writer.Key("callsign"); writer.String(fp.callsign.c_str());
+		writer.Key("origin"); writer.String(fp.origin.c_str());
+		writer.Key("destination"); writer.String(fp.destination.c_str());
+		writer.Key("route"); writer.String(fp.route.c_str());
+		writer.Key("sid"); writer.String(fp.sid.c_str());
+		writer.Key("rfl"); writer.Int(fp.rfl);
+		writer.Key("planType"); writer.String(fp.planType.c_str());
+		writer.Key("aircraftType"); writer.String(string(fp.aircraftType ? 1 : 0, fp.aircraftType).c_str());
+		writer.Key("engineType"); writer.String(string(fp.engineType ? 1 : 0, fp.engineType).c_str());
+		writer.Key("points");
+		writer.StartArray();
+		for (const string& each : fp.points) {
+			writer.String(each.c_str());
+		}
+		writer.EndArray();
+		writer.EndObject();
+
+		out << buffer.GetString() << '\n';
+	}
+
+	return true;
+}
+
+bool loadRules(const string& path, RuleSnapshot& out, vector<string>& diagnostics, string& error) {
+	if (endsWith(path, ".bin")) {
+		return loadRuleImage(path, out, error);
+	}
+
+	ifstream ifs(path.c_str(), ios::binary);
+	if (!ifs.is_open()) {
+		error = path + " Not Found";
+		return false;
+	}
+
+	stringstream ss;
+	ss << ifs.rdbuf();
+
+	Document data;
+	if (data.Parse<0>(ss.str().c_str()).HasParseError() || !data.IsArray()) {
+		error = path + " Unreadable (Offset " + to_string(data.GetErrorOffset()) + ")";
+		return false;
+	}
+
+	for (SizeType i = 0; i < data.Size(); i++) {
+		shared_ptr<AirportRules> rules = make_shared<AirportRules>();
+		vector<string> airportDiagnostics{};
+
+		if (compileAirport(data[i], *rules, airportDiagnostics)) {
+			for (const string& each : airportDiagnostics) {
+				diagnostics.push_back(rules->icao + " - " + each);
+			}
+
+			out.airports.insert(make_pair(rules->icao, rules));
+		}
+	}
+
+	return true;
+}
+
+void routePoints(FlightPlanView& fp) {
+	const unsigned notWaypoint = TOKEN_SPDLVL | TOKEN_SIDSTAR_RWY | TOKEN_ICAO_RWY | TOKEN_DCT_SPDLVL | TOKEN_AIRWAY;
+
+	fp.points.clear();
+	for (string token : splitFields(fp.route, ' ')) {
+		transform(token.begin(), token.end(), token.begin(), [](unsigned char c) { return static_cast<char>(toupper(c)); });
+
+		unsigned cls = classifyRouteToken(token);
+		if (token.empty() || (cls & notWaypoint) || token == "DCT" || token == "SID" || token == "STAR") {
+			continue;
+		}
+
+		fp.points.push_back(token.substr(0, token.find('/')));
+	}
+}
+
+int parseWeekTime(const string& s) {
+	if (s.size() != 6 || s[1] != ':' || !all_of(s.begin() + 2, s.end(), [](unsigned char c) { return isdigit(c); }) || s[0] < '0' || s[0] > '6') {
+		return -1;
+	}
+
+	int hours = toInt(s.substr(2, 2));
+	int minutes = toInt(s.substr(4, 2));
+	if (hours > 23 || minutes > 59) {
+		return -1;
+	}
+
+	return (s[0] - '0') * 1440 + hours * 60 + minutes;
+}
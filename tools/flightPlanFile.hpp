@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "ruleSnapshot.hpp"
+#include "flightPlanView.hpp"
+
+/***********************************************************
+* File input for the command line tools.
+*
+* Flight plans are read from either JSON lines (one object per
+* line) or CSV with a header row. Both use the field names
+*   callsign, origin, destination, route, sid, rfl, planType,
+*   aircraftType, engineType, points
+* where only callsign, origin and route are required. points
+* is an array in JSON and space separated in CSV; if it is
+* missing, the route's waypoints are used in its place (close
+* to EuroScope's extracted route whenever the exit point is
+* filed explicitly).
+*
+* A recording is JSON lines of flight plan states as they
+* were seen on the network, each with "t" (seconds from the
+* start of the recording) and the flight plan fields above. A
+* later state replaces the earlier one for the same callsign,
+* and "disconnect": true removes it.
+*
+* Sid.json is read in the same format the plugin loads, or as
+* a rule image (see ruleImage.hpp) if the name ends in .bin.
+***********************************************************/
+
+//Reads a flight plan file, format chosen by extension (.csv, else JSON lines). Returns false with error set if unreadable.
+bool readFlightPlans(const std::string& path, std::vector<FlightPlanView>& out, std::string& error);
+
+struct RecordedState {
+	double time = 0; //Seconds
+	bool disconnect = false;
+	FlightPlanView fp;
+};
+
+//Reads a recording, ordered by time. Returns false with error set if unreadable.
+bool readRecording(const std::string& path, std::vector<RecordedState>& out, std::string& error);
+
+//Writes flight plans as JSON lines, in the format readFlightPlans reads. Returns false with error set if unwritable.
+bool writeFlightPlans(const std::string& path, const std::vector<FlightPlanView>& flights, std::string& error);
+
+//Compiles a Sid.json file, or reads a .bin rule image. Returns false with error set if unreadable.
+bool loadRules(const std::string& path, RuleSnapshot& out, std::vector<std::string>& diagnostics, std::string& error);
+
+//Fills points from the waypoints of the route
+void routePoints(FlightPlanView& fp);
+
+//Parses "D:HHMM" (D: 0 = Monday) into a minute of the week, or -1
+int parseWeekTime(const std::string& s);
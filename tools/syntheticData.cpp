@@ -0,0 +1,338 @@
+#include "syntheticData.hpp"
+#include <random>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+
+typedef mt19937 Random;
+
+static int between(Random& r, int lo, int hi) {
+	return uniform_int_distribution<int>(lo, hi)(r);
+}
+
+static bool chance(Random& r, double p) {
+	return uniform_real_distribution<double>(0, 1)(r) < p;
+}
+
+template <typename T>
+static const T& pickOne(Random& r, const vector<T>& from) {
+	return from[between(r, 0, static_cast<int>(from.size()) - 1)];
+}
+
+static string letters(Random& r, int n) {
+	string out;
+	for (int i = 0; i < n; i++) {
+		out += static_cast<char>('A' + between(r, 0, 25));
+	}
+	return out;
+}
+
+//Deterministic name for an index, so data and traffic agree without sharing state
+static string indexName(const char* prefix, int i, int length) {
+	string out = prefix;
+	while (static_cast<int>(out.size()) < length) {
+		out += static_cast<char>('A' + i % 26);
+		i /= 26;
+	}
+	return out;
+}
+
+static string jsonArray(const vector<string>& items) {
+	string out = "[";
+	for (size_t i = 0; i < items.size(); i++) {
+		out += (i ? ",\"" : "\"") + items[i] + "\"";
+	}
+	return out + "]";
+}
+
+static vector<string> pickSome(Random& r, const vector<string>& from, int lo, int hi) {
+	vector<string> pool = from;
+	shuffle(pool.begin(), pool.end(), r);
+	pool.resize(min(static_cast<size_t>(between(r, lo, hi)), pool.size()));
+	return pool;
+}
+
+struct Vocabulary {
+	vector<string> waypoints;
+	vector<string> exits;
+	vector<string> airways;
+	vector<string> dests;
+};
+
+static Vocabulary vocabulary(int airports) {
+	Vocabulary v;
+	for (int i = 0; i < 400; i++) {
+		v.waypoints.push_back(indexName("", i * 7919 + 17, 5));
+	}
+	for (int i = 0; i < 40; i++) {
+		v.exits.push_back(indexName("X", i * 104729 + 3, 5));
+	}
+	const char* awys[] = { "L", "UL", "N", "UN", "M", "Q", "Y", "T", "P", "UP" };
+	for (int i = 0; i < 60; i++) {
+		v.airways.push_back(string(awys[i % 10]) + to_string(1 + i * 37 % 999));
+	}
+	const char* regions[] = { "EH", "ED", "LF", "EI", "EB", "LE", "LI", "EK", "ES", "EN", "LS", "LO", "K", "C" };
+	for (const char* each : regions) {
+		v.dests.push_back(each);
+	}
+	for (int i = 0; i < airports + 30; i++) {
+		v.dests.push_back(string(regions[i % 14]).substr(0, 2) + indexName("", i, 2));
+	}
+	return v;
+}
+
+static string restrictionJson(Random& r, bool allowSidLevel) {
+	static const vector<string> suffixes = { "F", "G", "J", "K", "L", "M", "X", "Z" };
+	static const vector<string> types = { "J", "P", "T", "H" };
+	vector<string> fields{};
+
+	if (chance(r, 0.5)) {
+		fields.push_back("\"suffix\":" + jsonArray(pickSome(r, suffixes, 1, 3)));
+	}
+	if (chance(r, 0.3)) {
+		fields.push_back("\"types\":" + jsonArray(pickSome(r, types, 1, 2)));
+	}
+	if (chance(r, 0.3)) {
+		char start[8], end[8];
+		snprintf(start, sizeof(start), "%02d%02d", between(r, 0, 23), between(r, 0, 3) * 15);
+		snprintf(end, sizeof(end), "%02d%02d", between(r, 0, 23), between(r, 0, 3) * 15);
+
+		if (chance(r, 0.5)) {
+			int from = between(r, 0, 6);
+			int to = between(r, 0, 6);
+			fields.push_back("\"start\":{\"date\":" + to_string(from) + ",\"time\":\"" + start + "\"},\"end\":{\"date\":" + to_string(to) + ",\"time\":\"" + end + "\"}");
+		}
+		else {
+			fields.push_back(string("\"start\":{\"time\":\"") + start + "\"},\"end\":{\"time\":\"" + end + "\"}");
+		}
+	}
+	if (chance(r, 0.05)) {
+		fields.push_back("\"banned\":true");
+	}
+	if (allowSidLevel && chance(r, 0.5)) {
+		fields.push_back("\"sidlevel\":true");
+	}
+	if (chance(r, 0.3)) {
+		fields.push_back("\"alt\":[\"Use a different SID\"]");
+	}
+
+	string out = "{";
+	for (size_t i = 0; i < fields.size(); i++) {
+		out += (i ? "," : "") + fields[i];
+	}
+	return out + "}";
+}
+
+static string routePattern(Random& r, const Vocabulary& v) {
+	if (chance(r, 0.03)) {
+		return "*";
+	}
+
+	//Airway/waypoint pairs, as SRD routes are written
+	string out;
+	int pairs = between(r, 1, 3);
+	for (int i = 0; i < pairs; i++) {
+		out += (i ? " " : "") + pickOne(r, v.airways) + " " + (chance(r, 0.08) ? string("*") : pickOne(r, v.waypoints));
+	}
+	return out;
+}
+
+static string constraintJson(Random& r, const Vocabulary& v) {
+	vector<string> fields{};
+
+	if (chance(r, 0.6)) {
+		fields.push_back("\"dests\":" + jsonArray(pickSome(r, v.dests, 1, 6)));
+	}
+	if (chance(r, 0.15)) {
+		fields.push_back("\"nodests\":" + jsonArray(pickSome(r, v.dests, 1, 3)));
+	}
+	if (chance(r, 0.5)) {
+		fields.push_back("\"points\":" + jsonArray(pickSome(r, v.exits, 1, 3)));
+	}
+	if (chance(r, 0.1)) {
+		fields.push_back("\"nopoints\":" + jsonArray(pickSome(r, v.exits, 1, 2)));
+	}
+	if (chance(r, 0.85)) {
+		vector<string> routes{};
+		for (int i = between(r, 1, 4); i > 0; i--) {
+			routes.push_back(routePattern(r, v));
+		}
+		fields.push_back("\"route\":" + jsonArray(routes));
+	}
+	if (chance(r, 0.1)) {
+		fields.push_back("\"noroute\":" + jsonArray({ routePattern(r, v) }));
+	}
+	if (chance(r, 0.6)) {
+		fields.push_back("\"min\":" + to_string(between(r, 0, 25) * 10));
+	}
+	if (chance(r, 0.6)) {
+		fields.push_back("\"max\":" + to_string(between(r, 25, 66) * 10));
+	}
+	if (chance(r, 0.4)) {
+		fields.push_back(chance(r, 0.5) ? "\"dir\":\"EVEN\"" : "\"dir\":\"ODD\"");
+	}
+	if (chance(r, 0.3)) {
+		fields.push_back("\"restrictions\":[" + restrictionJson(r, false) + "]");
+	}
+	if (chance(r, 0.15)) {
+		string alert = chance(r, 0.5) ? "{\"warn\":true,\"note\":\"Check NOTAM\"}" : "{\"ban\":true,\"srd\":" + to_string(between(r, 1, 400)) + "}";
+		fields.push_back("\"alerts\":[" + alert + "]");
+	}
+
+	string out = "{";
+	for (size_t i = 0; i < fields.size(); i++) {
+		out += (i ? "," : "") + fields[i];
+	}
+	return out + "}";
+}
+
+string syntheticSidJson(const SyntheticParams& params) {
+	Random r(params.seed);
+	Vocabulary v = vocabulary(params.airports);
+	ostringstream out;
+
+	out << "[";
+	for (int a = 0; a < params.airports; a++) {
+		out << (a ? ",\n" : "\n") << "{\"icao\":\"" << indexName("EG", a, 4) << "\",\"sids\":[";
+
+		vector<string> points = pickSome(r, v.waypoints, params.sids, params.sids);
+		for (int s = 0; s < params.sids; s++) {
+			out << (s ? ",\n" : "\n") << "{\"point\":\"" << points[s] << "\"";
+
+			if (chance(r, 0.1)) {
+				out << ",\"aliases\":[\"" << points[s].substr(0, 3) << "\"]";
+			}
+			if (chance(r, 0.2)) {
+				out << ",\"restrictions\":[" << restrictionJson(r, true) << "]";
+			}
+
+			out << ",\"constraints\":[";
+			for (int c = 0; c < params.constraints; c++) {
+				out << (c ? "," : "") << constraintJson(r, v);
+			}
+			out << "]}";
+		}
+		out << "]}";
+	}
+	out << "\n]\n";
+
+	return out.str();
+}
+
+//A flight plan filed against constraint con of sid at airport, valid as far as the route, destination and level go
+static FlightPlanView filedFlight(Random& r, const AirportRules& airport, const SidRule& sid, const ConstraintRule& con, const Vocabulary& v) {
+	static const vector<string> suffixes = { "F", "G", "J", "K", "L", "M", "X", "Z" };
+	FlightPlanView fp;
+
+	fp.origin = airport.icao;
+	fp.planType = "I";
+	fp.aircraftType = 'L';
+	fp.engineType = chance(r, 0.9) ? 'J' : 'T';
+	fp.sid = sid.point + to_string(between(r, 1, 9)) + pickOne(r, suffixes);
+
+	string dest = con.dests.size() ? pickOne(r, con.dests) : pickOne(r, v.dests);
+	fp.destination = dest.size() >= 4 ? dest.substr(0, 4) : dest + letters(r, 4 - static_cast<int>(dest.size()));
+
+	//Level inside the band, on the right side of the odd/even rule
+	int lo = con.minIsInt && con.min > 0 ? con.min : 70;
+	int hi = con.maxIsInt && con.max > 0 ? con.max : 410;
+	int fl = between(r, min(lo, hi), max(lo, hi));
+	if (con.dir == LevelDirection::Even && fl / 10 % 2) fl -= 10;
+	if (con.dir == LevelDirection::Odd && !(fl / 10 % 2)) fl -= 10;
+	fp.rfl = max(fl - fl % 10, 10) * 100;
+
+	string route = "N0450F" + to_string(fp.rfl / 100) + " " + sid.point;
+	if (con.route.size()) {
+		const string& pattern = pickOne(r, con.routeText);
+		if (pattern != "*") {
+			istringstream tokens(pattern);
+			string token;
+			while (tokens >> token) {
+				route += " " + (token == "*" ? pickOne(r, v.waypoints) : token);
+			}
+		}
+	}
+	route += " DCT " + pickOne(r, v.waypoints);
+
+	//Exit points are only known from EuroScope's extracted route
+	fp.route = route;
+	istringstream tokens(route);
+	string token;
+	while (tokens >> token) {
+		if (token.size() == 5 && find(v.waypoints.begin(), v.waypoints.end(), token) != v.waypoints.end()) {
+			fp.points.push_back(token);
+		}
+	}
+	if (con.points.size()) {
+		fp.points.push_back(airport.pool.str(pickOne(r, con.points)));
+	}
+	else {
+		fp.points.push_back(pickOne(r, v.exits));
+	}
+
+	return fp;
+}
+
+vector<FlightPlanView> syntheticFlights(const RuleSnapshot& rules, size_t count, unsigned seed) {
+	Random r(seed);
+	Vocabulary v = vocabulary(static_cast<int>(rules.airports.size()));
+	vector<FlightPlanView> out{};
+
+	vector<const AirportRules*> airports{};
+	for (const auto& each : rules.airports) {
+		if (each.second->sids.size()) {
+			airports.push_back(each.second.get());
+		}
+	}
+
+	if (airports.empty()) {
+		return out;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const AirportRules& airport = *pickOne(r, airports);
+		const SidRule& sid = pickOne(r, airport.sids);
+
+		FlightPlanView fp;
+		if (sid.constraints.size() && sid.point.size()) {
+			fp = filedFlight(r, airport, sid, pickOne(r, sid.constraints), v);
+		}
+		else {
+			fp.origin = airport.icao;
+			fp.planType = "I";
+			fp.destination = pickOne(r, v.dests) + "XX";
+			fp.route = "N0450F350 " + pickOne(r, v.waypoints) + " " + pickOne(r, v.airways) + " " + pickOne(r, v.waypoints);
+			fp.rfl = 35000;
+		}
+
+		//Break a share of them
+		switch (between(r, 0, 19)) {
+		case 0:
+			fp.rfl += 1000;
+			break;
+		case 1:
+			fp.destination = letters(r, 4);
+			break;
+		case 2:
+			fp.sid = letters(r, 5) + "1X";
+			break;
+		case 3:
+			fp.route += " DCT/N0450F350";
+			break;
+		case 4:
+			fp.planType = "V";
+			break;
+		case 5:
+			fp.sid = "";
+			break;
+		default:
+			break;
+		}
+
+		fp.callsign = "SYN" + to_string(i);
+		out.push_back(fp);
+	}
+
+	return out;
+}
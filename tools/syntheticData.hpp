@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "ruleSnapshot.hpp"
+#include "flightPlanView.hpp"
+
+/***********************************************************
+* Synthetic SID data and traffic for benchmarking.
+*
+* syntheticSidJson writes a Sid.json document shaped like the
+* SRD derived API data (airways and waypoints in the route
+* patterns, destination prefixes, exit points, level bands,
+* suffix/type/time restrictions, warn/ban alerts) at any size.
+*
+* syntheticFlights builds a traffic mix from compiled rules -
+* generated or real - by filing most flights against an actual
+* constraint and then breaking a share of them in the ways
+* controllers see (wrong level, destination, SID or route,
+* bad syntax, VFR). Both are deterministic for a given seed.
+***********************************************************/
+
+struct SyntheticParams {
+	int airports = 20;
+	int sids = 30; //Per airport
+	int constraints = 8; //Per SID
+	unsigned seed = 1;
+};
+
+std::string syntheticSidJson(const SyntheticParams& params);
+
+std::vector<FlightPlanView> syntheticFlights(const RuleSnapshot& rules, size_t count, unsigned seed);
@@ -0,0 +1,331 @@
+#include "flightPlanFile.hpp"
+#include "syntheticData.hpp"
+#include "sidChecker.hpp"
+#include "routeLexer.hpp"
+#include "rapidjson/document.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+/***********************************************************
+* vfpc-bench - microbenchmarks for the validation hot path.
+*
+*   vfpc-bench [-a airports] [-s sids] [-c constraints]
+*              [-f flights] [--seed n] [-r Sid.json]
+*              [-p flights] [-n ms] [-t D:HHMM] [--write dir]
+*
+* Rules come from -r or else syntheticSidJson sized by -a/-s/-c,
+* traffic from -p or else syntheticFlights (-f plans). Each
+* benchmark sweeps the traffic repeatedly for at least -n ms
+* and writes one JSON object per line to stdout:
+*   {"benchmark", "ops", "ns_per_op", "ops_per_s", "airports",
+*    "sids", "constraints", "flights", "seed"}
+* so runs can be diffed or collected by a script.
+*
+* The rounds are timed on their own with the route, exit
+* points and destination prepared up front the way validateSid
+* prepares them. --write saves the generated data as dir/Sid.json
+* and dir/flights.jsonl instead of benchmarking.
+***********************************************************/
+
+using namespace std;
+
+//Inputs of one flight plan for the individual rounds
+struct Prepared {
+	const FlightPlanView* fp = nullptr;
+	const AirportRules* airport = nullptr;
+	const SidRule* sid = nullptr;
+	string destination;
+	string suffix;
+	vector<StringId> points;
+	vector<StringId> route; //After the SID's first waypoint
+	vector<size_t> all; //Every constraint index, as successes for the output builders
+};
+
+struct BenchOptions {
+	SyntheticParams params;
+	size_t flights = 10000;
+	double minMs = 200;
+	int minuteOfWeek = 2 * 1440 + 12 * 60;
+	string rulesPath;
+	string flightsPath;
+	string writeDir;
+};
+
+static string upper(string s) {
+	transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(toupper(c)); });
+	return s;
+}
+
+//Route tokens after first_wp, without speed/level groups, DCT or /level changes
+static vector<StringId> routeIds(const AirportRules& airport, const string& route, const string& first_wp) {
+	vector<StringId> out{};
+	istringstream tokens(upper(route));
+	string token;
+	bool started = false;
+
+	while (tokens >> token) {
+		if (!started) {
+			started = token == first_wp;
+			continue;
+		}
+
+		if (token == "DCT" || (classifyRouteToken(token) & (TOKEN_SPDLVL | TOKEN_SIDSTAR_RWY | TOKEN_ICAO_RWY))) {
+			continue;
+		}
+
+		out.push_back(airport.pool.find(token.substr(0, token.find('/'))));
+	}
+
+	return out;
+}
+
+static vector<Prepared> prepare(const vector<FlightPlanView>& flights, const RuleSnapshot& rules) {
+	vector<Prepared> out{};
+
+	for (const FlightPlanView& fp : flights) {
+		auto apt = rules.airports.find(upper(fp.origin));
+		if (apt == rules.airports.end() || fp.sid.empty()) {
+			continue;
+		}
+
+		string sid = upper(fp.sid);
+		string first_wp = sid.substr(0, sid.find_first_of("0123456789"));
+		size_t pos = apt->second->findSid(first_wp);
+		if (pos == string::npos) {
+			continue;
+		}
+
+		Prepared p;
+		p.fp = &fp;
+		p.airport = apt->second.get();
+		p.sid = &p.airport->sids[pos];
+		p.destination = upper(fp.destination);
+		p.suffix = string(1, sid.back());
+
+		for (const string& each : fp.points) {
+			p.points.push_back(p.airport->pool.find(each));
+		}
+
+		p.route = routeIds(*p.airport, fp.route, first_wp);
+
+		for (size_t i = 0; i < p.sid->constraints.size(); i++) {
+			p.all.push_back(i);
+		}
+
+		out.push_back(p);
+	}
+
+	return out;
+}
+
+//Calls f(i) for i over [0, n) repeatedly until minMs has passed, then reports the time per call
+template <typename F>
+static void bench(const char* name, size_t n, const BenchOptions& options, F f) {
+	if (n == 0) {
+		return;
+	}
+
+	size_t sink = 0;
+	unsigned long long ops = 0;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	double elapsed = 0;
+
+	do {
+		for (size_t i = 0; i < n; i++) {
+			sink += f(i);
+		}
+		ops += n;
+		elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+	} while (elapsed < options.minMs);
+
+	double ns = elapsed * 1e6 / ops;
+
+	cout << "{\"benchmark\":\"" << name << "\",\"ops\":" << ops << ",\"ns_per_op\":" << ns << ",\"ops_per_s\":" << static_cast<long long>(1e9 / ns)
+		<< ",\"airports\":" << options.params.airports << ",\"sids\":" << options.params.sids << ",\"constraints\":" << options.params.constraints
+		<< ",\"flights\":" << n << ",\"seed\":" << options.params.seed << ",\"sink\":" << sink % 2 << "}" << endl;
+}
+
+static void usage() {
+	cerr << "Usage: vfpc-bench [-a airports] [-s sids] [-c constraints] [-f flights] [--seed n] [-r Sid.json] [-p flights] [-n ms] [-t D:HHMM] [--write dir]" << endl;
+}
+
+static bool parseOptions(int argc, char** argv, BenchOptions& options) {
+	for (int i = 1; i < argc; i++) {
+		bool more = i + 1 < argc;
+
+		if (!strcmp(argv[i], "-a") && more) options.params.airports = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-s") && more) options.params.sids = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-c") && more) options.params.constraints = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-f") && more) options.flights = static_cast<size_t>(atol(argv[++i]));
+		else if (!strcmp(argv[i], "--seed") && more) options.params.seed = static_cast<unsigned>(atol(argv[++i]));
+		else if (!strcmp(argv[i], "-r") && more) options.rulesPath = argv[++i];
+		else if (!strcmp(argv[i], "-p") && more) options.flightsPath = argv[++i];
+		else if (!strcmp(argv[i], "-n") && more) options.minMs = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--write") && more) options.writeDir = argv[++i];
+		else if (!strcmp(argv[i], "-t") && more) {
+			options.minuteOfWeek = parseWeekTime(argv[++i]);
+			if (options.minuteOfWeek < 0) {
+				cerr << "Time must be D:HHMM, D = 0 (Monday) to 6" << endl;
+				return false;
+			}
+		}
+		else {
+			usage();
+			return false;
+		}
+	}
+
+	if (options.params.airports < 1 || options.params.sids < 1 || options.params.constraints < 1) {
+		cerr << "-a, -s and -c must be at least 1" << endl;
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv) {
+	BenchOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		return 2;
+	}
+
+	string json;
+	if (options.rulesPath.size()) {
+		ifstream ifs(options.rulesPath.c_str(), ios::binary);
+		if (!ifs.is_open()) {
+			cerr << options.rulesPath << " Not Found" << endl;
+			return 1;
+		}
+
+		stringstream ss;
+		ss << ifs.rdbuf();
+		json = ss.str();
+	}
+	else {
+		json = syntheticSidJson(options.params);
+	}
+
+	RuleSnapshot rules;
+	vector<string> diagnostics{};
+	rapidjson::Document data;
+	if (data.Parse<0>(json.c_str()).HasParseError() || !data.IsArray()) {
+		cerr << "SID Data Unreadable" << endl;
+		return 1;
+	}
+
+	for (rapidjson::SizeType i = 0; i < data.Size(); i++) {
+		shared_ptr<AirportRules> compiled = make_shared<AirportRules>();
+		if (compileAirport(data[i], *compiled, diagnostics)) {
+			rules.airports.insert(make_pair(compiled->icao, compiled));
+		}
+	}
+
+	vector<FlightPlanView> flights{};
+	string error;
+	if (options.flightsPath.size()) {
+		if (!readFlightPlans(options.flightsPath, flights, error)) {
+			cerr << error << endl;
+			return 1;
+		}
+	}
+	else {
+		flights = syntheticFlights(rules, options.flights, options.params.seed);
+	}
+
+	if (options.writeDir.size()) {
+		ofstream out((options.writeDir + "/Sid.json").c_str(), ios::binary);
+		out << json;
+
+		if (!out || !writeFlightPlans(options.writeDir + "/flights.jsonl", flights, error)) {
+			cerr << (error.size() ? error : options.writeDir + " Not Writable") << endl;
+			return 1;
+		}
+
+		cerr << "Wrote " << rules.airports.size() << " Airports And " << flights.size() << " Flight Plans To " << options.writeDir << endl;
+		return 0;
+	}
+
+	SidChecker checker;
+	vector<Prepared> prepared = prepare(flights, rules);
+	const int minute = options.minuteOfWeek;
+
+	cerr << rules.airports.size() << " Airports, " << flights.size() << " Flight Plans, " << prepared.size() << " With A Known SID" << endl;
+
+	bench("compileAirport", data.Size(), options, [&](size_t i) {
+		AirportRules compiled;
+		vector<string> unused{};
+		compileAirport(data[static_cast<rapidjson::SizeType>(i)], compiled, unused);
+		return compiled.sids.size();
+	});
+
+	bench("validateSid", flights.size(), options, [&](size_t i) {
+		return static_cast<size_t>(checker.validateSid(flights[i], rules, minute).sidStatus);
+	});
+
+	vector<CheckResult> results{};
+	for (const FlightPlanView& fp : flights) {
+		results.push_back(checker.validateSid(fp, rules, minute));
+	}
+
+	bench("explainCheck", flights.size(), options, [&](size_t i) {
+		return checker.explainCheck(flights[i], results[i], rules)[0].size();
+	});
+
+	bench("checkDestination", prepared.size(), options, [&](size_t i) {
+		const Prepared& p = prepared[i];
+		ConstraintSet candidates(p.sid->constraints.size());
+		checker.checkDestination(p.sid->index, p.destination, candidates);
+		return static_cast<size_t>(candidates.none());
+	});
+
+	bench("checkExitPoint", prepared.size(), options, [&](size_t i) {
+		const Prepared& p = prepared[i];
+		ConstraintSet candidates(p.sid->constraints.size());
+		checker.checkExitPoint(p.sid->index, p.points, candidates);
+		return static_cast<size_t>(candidates.none());
+	});
+
+	bench("checkRoute", prepared.size(), options, [&](size_t i) {
+		const Prepared& p = prepared[i];
+		ConstraintSet candidates(p.sid->constraints.size());
+		checker.checkRoute(p.sid->index, p.route, candidates);
+		return static_cast<size_t>(candidates.none());
+	});
+
+	bench("checkRestrictions", prepared.size(), options, [&](size_t i) {
+		const Prepared& p = prepared[i];
+		ConstraintSet candidates(p.sid->constraints.size());
+		bool sidFails[4]{}, restFails[4]{};
+		bool sidwide = false;
+		int windowChange = -1;
+		checker.checkRestriction(*p.fp, p.suffix, p.sid->restrictions, sidFails, sidFails, minute, &windowChange);
+		checker.checkRestrictions(*p.fp, p.sid->constraints, p.suffix, sidFails, restFails, &sidwide, minute, &windowChange, candidates);
+		return static_cast<size_t>(candidates.none());
+	});
+
+	bench("RouteOutput", prepared.size(), options, [&](size_t i) {
+		const Prepared& p = prepared[i];
+		return checker.RouteOutput(*p.fp, *p.airport, p.sid->constraints, p.all, p.route, p.destination, p.fp->rfl).size();
+	});
+
+	bench("ExitPointOutput", prepared.size(), options, [&](size_t i) {
+		const Prepared& p = prepared[i];
+		return checker.ExitPointOutput(*p.fp, *p.airport, p.points).size();
+	});
+
+	bench("DestinationOutput", prepared.size(), options, [&](size_t i) {
+		const Prepared& p = prepared[i];
+		return checker.DestinationOutput(*p.fp, *p.airport, p.destination).size();
+	});
+
+	bench("RestrictionsOutput", prepared.size(), options, [&](size_t i) {
+		const Prepared& p = prepared[i];
+		return checker.RestrictionsOutput(*p.fp, *p.sid, true, true, true, p.all).size();
+	});
+
+	return 0;
+}
@@ -0,0 +1,155 @@
+#include "flightPlanFile.hpp"
+#include "sidChecker.hpp"
+#include "tagCheck.hpp"
+#include "timeSource.hpp"
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+/***********************************************************
+* vfpc-check - batch flight plan checker.
+*
+*   vfpc-check [-j threads] [-t D:HHMM] [-d] Sid.json flights
+*
+* Checks every flight plan in flights (see flightPlanFile.hpp)
+* against Sid.json, spread over all cores, and writes one line
+* per flight plan, in input order, to stdout:
+*   callsign <TAB> code [<TAB> detail]
+* where code is the departure list code (SID, RTE, LVL, OER,
+* BAN, OK!, ...) and detail (-d) the "Show Checks" text.
+* Restriction windows are evaluated at -t (D: 0 = Monday) or
+* else the current UTC time. A summary and throughput go to
+* stderr.
+***********************************************************/
+
+using namespace std;
+
+struct CheckOutput {
+	const char* code = "";
+	string detail;
+};
+
+static void usage() {
+	cerr << "Usage: vfpc-check [-j threads] [-t D:HHMM] [-d] Sid.json flights.jsonl|flights.csv" << endl;
+}
+
+int main(int argc, char** argv) {
+	unsigned threads = thread::hardware_concurrency();
+	int minuteOfWeek = -1;
+	bool detail = false;
+	vector<string> files{};
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+			threads = static_cast<unsigned>(atoi(argv[++i]));
+		}
+		else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+			minuteOfWeek = parseWeekTime(argv[++i]);
+			if (minuteOfWeek < 0) {
+				cerr << "Time must be D:HHMM, D = 0 (Monday) to 6" << endl;
+				return 2;
+			}
+		}
+		else if (!strcmp(argv[i], "-d")) {
+			detail = true;
+		}
+		else {
+			files.push_back(argv[i]);
+		}
+	}
+
+	if (files.size() != 2) {
+		usage();
+		return 2;
+	}
+
+	if (threads == 0) {
+		threads = 1;
+	}
+
+	if (minuteOfWeek < 0) {
+		minuteOfWeek = TimeSource().minuteOfWeek();
+	}
+
+	RuleSnapshot rules;
+	vector<string> diagnostics{};
+	vector<FlightPlanView> flights{};
+	string error;
+
+	if (!loadRules(files[0], rules, diagnostics, error) || !readFlightPlans(files[1], flights, error)) {
+		cerr << error << endl;
+		return 1;
+	}
+
+	for (const string& each : diagnostics) {
+		cerr << "SID Data: " << each << endl;
+	}
+
+	SidChecker checker;
+	vector<CheckOutput> results(flights.size());
+	atomic<size_t> next{ 0 };
+	const size_t batch = 64;
+
+	auto worker = [&]() {
+		for (size_t start = next.fetch_add(batch); start < flights.size(); start = next.fetch_add(batch)) {
+			for (size_t i = start; i < start + batch && i < flights.size(); i++) {
+				const FlightPlanView& fp = flights[i];
+
+				if (isVfrPlan(fp.planType)) {
+					results[i].code = "VFR";
+					if (detail) {
+						results[i].detail = "Flight Plan Checking Not Supported For VFR Flights.";
+					}
+					continue;
+				}
+
+				CheckResult result = checker.validateSid(fp, rules, minuteOfWeek);
+				results[i].code = resultCode(result);
+
+				if (detail) {
+					vector<vector<string>> text = checker.explainCheck(fp, result, rules);
+					results[i].detail = SidChecker::joinExplanation(text[0], text[0].at(1).find("Invalid") != 0);
+				}
+			}
+		}
+	};
+
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+
+	vector<thread> pool{};
+	for (unsigned i = 1; i < threads; i++) {
+		pool.push_back(thread(worker));
+	}
+	worker();
+	for (thread& each : pool) {
+		each.join();
+	}
+
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+	map<string, size_t> counts{};
+	for (size_t i = 0; i < flights.size(); i++) {
+		cout << flights[i].callsign << '\t' << results[i].code;
+		if (detail) {
+			cout << '\t' << results[i].detail;
+		}
+		cout << '\n';
+
+		counts[results[i].code]++;
+	}
+	cout.flush();
+
+	for (const auto& each : counts) {
+		cerr << each.first << ": " << each.second << endl;
+	}
+
+	cerr << "Checked " << flights.size() << " Flight Plans In " << seconds * 1000 << " ms On " << threads << " Threads";
+	if (seconds > 0) {
+		cerr << " (" << static_cast<long long>(flights.size() / seconds) << " Plans/s)";
+	}
+	cerr << endl;
+
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "routeLexer.hpp"
+#include <iostream>
+#include <regex>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+
+/***********************************************************
+* vfpc-lexer-test - checks classifyRouteToken against the
+* std::regex patterns it replaced.
+*
+*   vfpc-lexer-test [-n tokens] [--seed n]
+*
+* Every token of a fixed list, then -n (default 200000)
+* tokens generated from route fragments and random characters
+* (seeded by --seed), is classified both ways. Each mismatch
+* is printed with both masks, and the exit code is 1 if there
+* was any.
+***********************************************************/
+
+using namespace std;
+
+//The patterns validateSid matched route tokens against before routeLexer
+struct RegexClassifier {
+	regex spdlvl{ "(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4})" };
+	regex spdlvlslash{ "/(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4})((A|F)[0-9]{3}|(S|M)[0-9]{4})?" };
+	regex icaorwy{ "[A-Z]{4}(/[0-9]{2}(L|C|R)?)?" };
+	regex sidstarrwy{ "[A-Z]{2,5}[0-9][A-Z](/[0-9]{2}(L|C|R)?)?" };
+	regex dctspdlvl{ "DCT/(N|M|K)[0-9]{3,4}((A|F)[0-9]{3}|(S|M)[0-9]{4})" };
+	regex awy{ "(U)?[A-Z][0-9]{1,3}([A-Z])?" };
+
+	unsigned classify(const string& token) const {
+		unsigned out = TOKEN_WAYPOINT;
+
+		if (regex_match(token, spdlvl)) out |= TOKEN_SPDLVL;
+		if (regex_match(token, sidstarrwy)) out |= TOKEN_SIDSTAR_RWY;
+		if (regex_match(token, icaorwy)) out |= TOKEN_ICAO_RWY;
+		if (regex_match(token, dctspdlvl)) out |= TOKEN_DCT_SPDLVL;
+		if (regex_match(token, awy)) out |= TOKEN_AIRWAY;
+
+		//validateSid matched the text from the first '/' of a token
+		size_t slash = token.find('/');
+		if (slash != string::npos && regex_match(token.substr(slash), spdlvlslash)) out |= TOKEN_SPDLVL_CHANGE;
+
+		return out;
+	}
+};
+
+static const char* const FIXED[] = {
+	"", "A", "/", "DCT", "DCT/", "EGLL", "EGLL/27", "EGLL/27L", "EGLL/27X", "EGLL/2", "EGLL/270", "EGL", "EGLLX",
+	"CPT3G", "BPK7F/27R", "MAXI1X", "ABCDEF1A", "A1A", "AB1", "AB12A", "DET2Z/09", "DET2Z/9", "LAM", "LAM1A/27C",
+	"N0450F350", "M082F370", "K0830S1130", "N045F350", "N04500F350", "N0450A045", "N0450F35", "N0450M0840", "N0450S11300",
+	"DCT/N0450F350", "DCT/N0450F35", "DCT/M082F370", "DCTN0450F350", "XDCT/N0450F350",
+	"L9", "UL620", "M145", "Q41A", "U1", "UL", "L9999", "UL9A", "UUL9", "Y3AB", "N0", "M1234",
+	"LAM/N0450F350", "LAM/N0450F350F390", "LAM/N0450F350S1130", "LAM/N0450F350F39", "LAM/N0450", "LAM/",
+	"LAM/N0450F350/N0450F350", "5130N00028W/N0450F350", "LAM/DCT", "/N0450F350", "//N0450F350",
+	"EGLL/N0450F350", "CPT3G/N0450F350", "L9/N0450F350", "N0450F350/27L",
+	"\xC4GLL", "egll", "N0450f350",
+};
+
+//Pieces tokens are commonly made of, so the sweep reaches the interesting boundaries
+static const char* const FRAGMENTS[] = {
+	"N", "M", "K", "A", "F", "S", "U", "L", "C", "R", "D", "T", "DCT", "EGLL", "CPT", "LAM", "/", "0", "1", "27",
+	"045", "0450", "04500", "350", "1130", "F350", "S1130", "N0450", "M082", "/27L", "/09", "3G", "9", "620",
+};
+
+static string randomToken(mt19937& rng) {
+	string out;
+	size_t parts = rng() % 6;
+
+	for (size_t i = 0; i < parts; i++) {
+		if (rng() % 4 == 0) {
+			static const char chars[] = "ACDFKLMNRSTUXZ0123456789/";
+			out += chars[rng() % (sizeof(chars) - 1)];
+		}
+		else {
+			out += FRAGMENTS[rng() % (sizeof(FRAGMENTS) / sizeof(FRAGMENTS[0]))];
+		}
+	}
+
+	return out;
+}
+
+static void usage() {
+	cerr << "Usage: vfpc-lexer-test [-n tokens] [--seed n]" << endl;
+}
+
+int main(int argc, char** argv) {
+	unsigned long count = 200000;
+	unsigned seed = 1;
+
+	for (int i = 1; i < argc; i++) {
+		bool more = i + 1 < argc;
+
+		if (!strcmp(argv[i], "-n") && more) count = strtoul(argv[++i], nullptr, 10);
+		else if (!strcmp(argv[i], "--seed") && more) seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+		else {
+			usage();
+			return 2;
+		}
+	}
+
+	RegexClassifier expected;
+	unsigned long checked = 0;
+	unsigned long mismatches = 0;
+
+	auto check = [&](const string& token) {
+		unsigned want = expected.classify(token);
+		unsigned got = classifyRouteToken(token);
+		checked++;
+
+		if (want != got) {
+			mismatches++;
+			cout << "Mismatch: \"" << token << "\" regex 0x" << hex << want << " lexer 0x" << got << dec << endl;
+		}
+	};
+
+	for (const char* token : FIXED) {
+		check(token);
+	}
+
+	mt19937 rng(seed);
+	for (unsigned long i = 0; i < count; i++) {
+		check(randomToken(rng));
+	}
+
+	cout << checked << " Tokens Checked, " << mismatches << " Mismatches (Seed " << seed << ")" << endl;
+	return mismatches ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+#include "flightPlanFile.hpp"
+#include "syntheticData.hpp"
+#include "ruleImage.hpp"
+#include "sidChecker.hpp"
+#include "timeSource.hpp"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+
+/***********************************************************
+* vfpc-pack - converts SID data to a binary rule image.
+*
+*   vfpc-pack [-v] Sid.json Sid.bin
+*
+* Compiles Sid.json (or a saved API airport response, which is
+* in the same format) and writes the result as a rule image
+* (see ruleImage.hpp), which the plugin's ".vfpc file" loads in
+* place of Sid.json when it is found next to the DLL. Reports
+* how long each takes to load.
+*
+* -v checks the image before finishing: generated traffic is
+* run through both the JSON and the image rules at times
+* across the week, and any flight plan whose result or "Show
+* Checks" text differs is listed. Exits 1 if any does.
+***********************************************************/
+
+using namespace std;
+
+static void usage() {
+	cerr << "Usage: vfpc-pack [-v] Sid.json Sid.bin" << endl;
+}
+
+//Milliseconds f takes
+template <typename F>
+static double timed(F f) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	f();
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+//Flight plans whose checks come out differently against the two rule sets
+static size_t compare(const RuleSnapshot& json, const RuleSnapshot& image) {
+	SidChecker checker;
+	vector<FlightPlanView> flights = syntheticFlights(json, 2000, 1);
+	size_t differ = 0;
+
+	for (int minute = 0; minute < MINUTES_PER_WEEK; minute += 1440 / 4 + 17) {
+		for (const FlightPlanView& fp : flights) {
+			CheckResult a = checker.validateSid(fp, json, minute);
+			CheckResult b = checker.validateSid(fp, image, minute);
+
+			if (strcmp(resultCode(a), resultCode(b)) || a.windowChange != b.windowChange || checker.explainCheck(fp, a, json) != checker.explainCheck(fp, b, image)) {
+				cerr << fp.callsign << " Differs At Minute " << minute << endl;
+				differ++;
+			}
+		}
+	}
+
+	return differ;
+}
+
+int main(int argc, char** argv) {
+	bool verify = false;
+	vector<string> files{};
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-v")) {
+			verify = true;
+		}
+		else {
+			files.push_back(argv[i]);
+		}
+	}
+
+	if (files.size() != 2) {
+		usage();
+		return 2;
+	}
+
+	RuleSnapshot rules;
+	vector<string> diagnostics{};
+	string error;
+	bool loaded = false;
+
+	double jsonMs = timed([&] { loaded = loadRules(files[0], rules, diagnostics, error); });
+	if (!loaded || !saveRuleImage(rules, files[1], error)) {
+		cerr << error << endl;
+		return 1;
+	}
+
+	RuleSnapshot image;
+	double imageMs = timed([&] { loaded = loadRuleImage(files[1], image, error); });
+	if (!loaded) {
+		cerr << error << endl;
+		return 1;
+	}
+
+	cerr << "Packed " << image.airports.size() << " Airports To " << files[1] << " - Loads In " << imageMs << " ms (" << files[0] << " " << jsonMs << " ms)" << endl;
+
+	if (verify) {
+		size_t differ = compare(rules, image);
+		cerr << (differ ? to_string(differ) + " Checks Differ" : string("Image Verified")) << endl;
+		return differ ? 1 : 0;
+	}
+
+	return 0;
+}
@@ -0,0 +1,245 @@
+#include "flightPlanFile.hpp"
+#include "tagCheck.hpp"
+#include "timeSource.hpp"
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <map>
+#include <algorithm>
+
+/***********************************************************
+* vfpc-replay - replays recorded traffic through the tag path.
+*
+*   vfpc-replay [-x speed] [-i seconds] [-t D:HHMM] Sid.json
+*               recording.jsonl
+*
+* Steps through a recording (see flightPlanFile.hpp) one
+* departure list refresh at a time (-i, default 1 s). Before
+* each refresh the states due by then are applied: a changed
+* flight plan drops its cached result as the EuroScope update
+* callbacks do. The refresh then asks for the tag item of
+* every flight plan on the list through cachedCheck, which
+* runs a miss in line where the plugin hands it to its
+* validator threads, after marking stale the results whose
+* restriction window opened or closed as OnTimer does.
+*
+* -x paces the replay at that multiple of real time (default
+* 1, 0 = as fast as possible). Restriction windows are
+* evaluated at -t plus the time into the recording.
+*
+* Writes one JSON object to stdout with refresh and tag item
+* latency percentiles (microseconds), cache hits and misses,
+* results rechecked for a restriction window, and heap allocations per refresh and per tag item.
+***********************************************************/
+
+using namespace std;
+
+//Heap allocations made by this process, counted to see what a refresh costs beyond time
+static atomic<unsigned long long> allocations{ 0 };
+
+void* operator new(size_t size) {
+	allocations++;
+	void* p = malloc(size ? size : 1);
+	if (!p) {
+		throw bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+	free(p);
+}
+
+struct ReplayOptions {
+	double speed = 1;
+	double interval = 1; //Seconds between refreshes
+	int minuteOfWeek = 2 * 1440 + 12 * 60;
+	vector<string> files;
+};
+
+//Value at fraction q of sorted samples
+static double percentile(const vector<double>& sorted, double q) {
+	if (sorted.empty()) {
+		return 0;
+	}
+
+	size_t i = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+	return sorted[min(i, sorted.size() - 1)];
+}
+
+static void writePercentiles(const char* name, vector<double>& samples) {
+	sort(samples.begin(), samples.end());
+
+	cout << ",\"" << name << "\":{\"count\":" << samples.size() << ",\"p50\":" << percentile(samples, 0.5) << ",\"p90\":" << percentile(samples, 0.9)
+		<< ",\"p99\":" << percentile(samples, 0.99) << ",\"max\":" << (samples.empty() ? 0 : samples.back()) << "}";
+}
+
+static void usage() {
+	cerr << "Usage: vfpc-replay [-x speed] [-i seconds] [-t D:HHMM] Sid.json recording.jsonl" << endl;
+}
+
+static bool parseOptions(int argc, char** argv, ReplayOptions& options) {
+	for (int i = 1; i < argc; i++) {
+		bool more = i + 1 < argc;
+
+		if (!strcmp(argv[i], "-x") && more) options.speed = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-i") && more) options.interval = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-t") && more) {
+			options.minuteOfWeek = parseWeekTime(argv[++i]);
+			if (options.minuteOfWeek < 0) {
+				cerr << "Time must be D:HHMM, D = 0 (Monday) to 6" << endl;
+				return false;
+			}
+		}
+		else {
+			options.files.push_back(argv[i]);
+		}
+	}
+
+	if (options.files.size() != 2 || options.interval <= 0 || options.speed < 0) {
+		usage();
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv) {
+	ReplayOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		return 2;
+	}
+
+	RuleSnapshot rules;
+	vector<string> diagnostics{};
+	vector<RecordedState> recording{};
+	string error;
+
+	if (!loadRules(options.files[0], rules, diagnostics, error) || !readRecording(options.files[1], recording, error)) {
+		cerr << error << endl;
+		return 1;
+	}
+
+	SidChecker checker;
+	ResultCache<CheckResult> cache;
+
+	//The departure list, in the order flight plans appeared
+	vector<FlightPlanView> list{};
+	map<string, size_t> position{};
+
+	vector<double> refreshMicros{};
+	vector<double> itemMicros{};
+	unsigned long long refreshAllocations = 0;
+	unsigned long long updates = 0;
+	unsigned long long disconnects = 0;
+	unsigned long long flagged = 0; //Tag items showing anything but OK!
+	unsigned long long rechecks = 0; //Results dropped because a restriction window opened or closed
+	size_t peakList = 0;
+
+	double end = recording.empty() ? 0 : recording.back().time;
+	size_t next = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	for (double now = 0; now <= end + options.interval; now += options.interval) {
+		if (options.speed > 0) {
+			this_thread::sleep_until(start + chrono::microseconds(static_cast<long long>(now / options.speed * 1e6)));
+		}
+
+		//Network updates due by now
+		for (; next < recording.size() && recording[next].time <= now; next++) {
+			const RecordedState& state = recording[next];
+			map<string, size_t>::iterator it = position.find(state.fp.callsign);
+
+			if (state.disconnect) {
+				if (it != position.end()) {
+					size_t gone = it->second;
+					list.erase(list.begin() + gone);
+					position.erase(it);
+					for (auto& each : position) {
+						if (each.second > gone) {
+							each.second--;
+						}
+					}
+					disconnects++;
+				}
+				cache.erase(state.fp.callsign);
+			}
+			else if (it == position.end()) {
+				position[state.fp.callsign] = list.size();
+				list.push_back(state.fp);
+			}
+			else {
+				list[it->second] = state.fp;
+				cache.invalidate(state.fp.callsign);
+				updates++;
+			}
+		}
+
+		peakList = max(peakList, list.size());
+
+		int minuteOfWeek = (options.minuteOfWeek + static_cast<int>(now / 60)) % MINUTES_PER_WEEK;
+		vector<string> expired{};
+		cache.expire(minuteOfWeek, expired);
+		rechecks += expired.size();
+
+		vector<double> itemTimes{};
+		itemTimes.reserve(list.size());
+
+		unsigned long long allocationsBefore = allocations.load();
+		chrono::steady_clock::time_point refreshStart = chrono::steady_clock::now();
+
+		//One OnGetTagItem per flight plan on the list
+		for (const FlightPlanView& fp : list) {
+			chrono::steady_clock::time_point itemStart = chrono::steady_clock::now();
+
+			if (rules.airports.find(fp.origin) != rules.airports.end() && !isVfrPlan(fp.planType)) {
+				//Only the fields EuroScope hands over up front - the extracted route is read on a miss
+				FlightPlanView view = fp;
+				view.points.clear();
+
+				const CheckResult& result = cachedCheck(checker, cache, view, makeCheckKey(view, rules), rules, minuteOfWeek, [&fp](FlightPlanView& out) { out.points = fp.points; });
+				flagged += strcmp(resultCode(result), "OK!") != 0;
+			}
+
+			itemTimes.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - itemStart).count());
+		}
+
+		refreshMicros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - refreshStart).count());
+		refreshAllocations += allocations.load() - allocationsBefore;
+		itemMicros.insert(itemMicros.end(), itemTimes.begin(), itemTimes.end());
+	}
+
+	double wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	unsigned long long lookups = cache.hitCount() + cache.missCount();
+
+	cout << "{\"recording_s\":" << end << ",\"wall_s\":" << wall << ",\"speed\":" << options.speed << ",\"interval_s\":" << options.interval
+		<< ",\"states\":" << recording.size() << ",\"updates\":" << updates << ",\"disconnects\":" << disconnects << ",\"peak_list\":" << peakList;
+	writePercentiles("refresh_us", refreshMicros);
+	writePercentiles("item_us", itemMicros);
+	cout << ",\"flagged_items\":" << flagged << ",\"cache_hits\":" << cache.hitCount() << ",\"cache_misses\":" << cache.missCount() << ",\"rechecks\":" << rechecks
+		<< ",\"cache_hit_rate\":" << (lookups ? static_cast<double>(cache.hitCount()) / lookups : 0)
+		<< ",\"allocations_per_refresh\":" << (refreshMicros.empty() ? 0 : static_cast<double>(refreshAllocations) / refreshMicros.size())
+		<< ",\"allocations_per_item\":" << (itemMicros.empty() ? 0 : static_cast<double>(refreshAllocations) / itemMicros.size()) << "}" << endl;
+
+	return 0;
+}